@@ -0,0 +1,43 @@
+# Builds a test that runs the whole keyboard pipeline natively: the real
+# tmk_core and quantum code on top of the simulated matrix, timer and host
+# driver found in tests/test_common and tmk_core/common/test.
+
+# A test that only differs from another one in config.h names that test's
+# directory in its rules.mk to build the same keymap and cases
+TEST_SOURCE_PATH ?= $(TEST_PATH)
+
+$(TEST)_INC := \
+	tests \
+	tests/test_common
+
+$(TEST)_SRC := \
+	$(TEST_SOURCE_PATH)/keymap.c \
+	$(TMK_COMMON_SRC) \
+	$(QUANTUM_DIR)/quantum.c \
+	$(QUANTUM_DIR)/keymap_common.c \
+	$(QUANTUM_DIR)/keycode_config.c \
+	$(QUANTUM_DIR)/process_keycode/process_leader.c \
+	tests/test_common/matrix.c \
+	tests/test_common/fn_actions.c \
+	tests/test_common/test_driver.cpp \
+	tests/test_common/keyboard_report_util.cpp \
+	tests/test_common/test_fixture.cpp \
+	$(wildcard $(TEST_SOURCE_PATH)/*.cpp)
+
+ifeq ($(strip $(TAP_DANCE_ENABLE)), yes)
+	OPT_DEFS += -DTAP_DANCE_ENABLE
+	$(TEST)_SRC += $(QUANTUM_DIR)/process_keycode/process_tap_dance.c
+endif
+
+# Links the generated keymap_actions[] without ACTION_TABLE_ENABLE, so the
+# test can hold it against the runtime decode in action_for_key()
+ifeq ($(strip $(ACTION_TABLE_GENERATE)), yes)
+	KEYMAP_C := $(TEST_SOURCE_PATH)/keymap.c
+	KEYMAP_OUTPUT := $(TEST_OBJ)/$(TEST)
+	ACTION_TABLE_OBJCOPY := objcopy
+	include $(QUANTUM_PATH)/action_table.mk
+	$(TEST)_SRC += $(ACTION_TABLE_SRC)
+endif
+
+$(TEST)_DEFS := $(TMK_COMMON_DEFS) $(OPT_DEFS)
+$(TEST)_CONFIG := $(TEST_PATH)/config.h
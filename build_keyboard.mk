@@ -120,6 +120,7 @@ SRC += $(KEYBOARD_C) \
 	$(KEYMAP_C) \
 	$(QUANTUM_DIR)/quantum.c \
 	$(QUANTUM_DIR)/keymap_common.c \
+	$(QUANTUM_DIR)/keymap_fn_actions.c \
 	$(QUANTUM_DIR)/keycode_config.c \
 	$(QUANTUM_DIR)/process_keycode/process_leader.c
 
@@ -129,6 +130,15 @@ endif
 
 ifndef CUSTOM_MATRIX
 	SRC += $(QUANTUM_DIR)/matrix.c
+	DEBOUNCE_TYPE ?= sym_g
+endif
+
+# Custom matrices can opt in to the debounce algorithms by setting DEBOUNCE_TYPE
+ifneq ($(strip $(DEBOUNCE_TYPE)),)
+    ifeq ("$(wildcard $(QUANTUM_PATH)/debounce/$(strip $(DEBOUNCE_TYPE)).c)","")
+        $(error DEBOUNCE_TYPE="$(DEBOUNCE_TYPE)" is not a valid debounce algorithm)
+    endif
+	SRC += $(QUANTUM_DIR)/debounce/$(strip $(DEBOUNCE_TYPE)).c
 endif
 
 ifeq ($(strip $(API_SYSEX_ENABLE)), yes)
@@ -188,6 +198,11 @@ ifeq ($(strip $(PRINTING_ENABLE)), yes)
 	SRC += $(TMK_DIR)/protocol/serial_uart.c
 endif
 
+ifeq ($(strip $(ACTION_TABLE_ENABLE)), yes)
+	OPT_DEFS += -DACTION_TABLE_ENABLE
+	include $(QUANTUM_PATH)/action_table.mk
+endif
+
 ifeq ($(strip $(SERIAL_LINK_ENABLE)), yes)
 	SRC += $(patsubst $(QUANTUM_PATH)/%,%,$(SERIAL_SRC))
 	OPT_DEFS += $(SERIAL_DEFS)
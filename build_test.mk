@@ -41,12 +41,25 @@ all: elf
 
 VPATH += $(COMMON_VPATH)
 
+TEST_PATH := tests/$(TEST)
+
+ifneq ($(wildcard $(TEST_PATH)/rules.mk),)
+    FULL_TEST := yes
+    PLATFORM := TEST
+    include $(TEST_PATH)/rules.mk
+endif
+
 include $(TMK_PATH)/common.mk
 include $(QUANTUM_PATH)/serial_link/tests/rules.mk
+include $(QUANTUM_PATH)/debounce/tests/rules.mk
+ifeq ($(FULL_TEST),yes)
+    include build_full_test.mk
+endif
 
 $(TEST_OBJ)/$(TEST)_SRC := $($(TEST)_SRC)
 $(TEST_OBJ)/$(TEST)_INC := $($(TEST)_INC) $(VPATH) $(GTEST_INC)
 $(TEST_OBJ)/$(TEST)_DEFS := $($(TEST)_DEFS)
+$(TEST_OBJ)/$(TEST)_CONFIG := $($(TEST)_CONFIG)
 
 include $(TMK_PATH)/native.mk
 include $(TMK_PATH)/rules.mk
@@ -0,0 +1,104 @@
+#ifndef ACTION_TABLE_H
+#define ACTION_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keycode.h"
+#include "action_code.h"
+#include "report.h"
+#include "quantum_keycodes.h"
+
+/* Keycode to action decoding shared by action_for_key() and the build time
+ * generator in quantum/tools/gen_action_table.c.
+ *
+ * With ACTION_TABLE_ENABLE = yes the keymaps[] array of the compiled keymap is
+ * decoded once at build time into keymap_actions[], a flat PROGMEM table with
+ * one action per keymap entry. Keycodes whose action depends on runtime state
+ * (keymap_config remaps, fn_actions, backlight) are stored as ACTION_DYNAMIC
+ * and still go through the full decode in action_for_key().
+ *
+ * The table mirrors keymaps[] as compiled, so keyboards that override
+ * keymap_key_to_keycode() to read keymaps from elsewhere must not enable it.
+ */
+
+/* action kind 0111 is unused, the value never reaches process_action */
+#define ACTION_DYNAMIC 0x7000
+
+#ifdef ACTION_TABLE_ENABLE
+extern const uint16_t keymap_actions[];
+extern const uint16_t keymap_actions_count;
+#endif
+
+/* Decode the keycodes whose action is a pure function of the keycode.
+ * Returns false for the ones that need runtime state.
+ */
+static inline bool keycode_to_static_action(uint16_t keycode, action_t *action)
+{
+    switch (keycode) {
+        case KC_FN0 ... KC_FN31:
+            return false;
+        case KC_A ... KC_EXSEL:
+        case KC_LCTRL ... KC_RGUI:
+            action->code = ACTION_KEY(keycode);
+            break;
+        case KC_SYSTEM_POWER ... KC_SYSTEM_WAKE:
+            action->code = ACTION_USAGE_SYSTEM(KEYCODE2SYSTEM(keycode));
+            break;
+        case KC_AUDIO_MUTE ... KC_MEDIA_REWIND:
+            action->code = ACTION_USAGE_CONSUMER(KEYCODE2CONSUMER(keycode));
+            break;
+        case KC_MS_UP ... KC_MS_ACCEL2:
+            action->code = ACTION_MOUSEKEY(keycode);
+            break;
+        case KC_TRNS:
+            action->code = ACTION_TRANSPARENT;
+            break;
+        case QK_MODS ... QK_MODS_MAX:
+            // Has a modifier
+            // Split it up
+            action->code = ACTION_MODS_KEY(keycode >> 8, keycode & 0xFF); // adds modifier to key
+            break;
+        case QK_FUNCTION ... QK_FUNCTION_MAX:
+            // fn_actions lookup
+            return false;
+        case QK_MACRO ... QK_MACRO_MAX:
+            action->code = ACTION_MACRO(keycode & 0xFF);
+            break;
+        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+            action->code = ACTION_LAYER_TAP_KEY((keycode >> 0x8) & 0xF, keycode & 0xFF);
+            break;
+        case QK_TO ... QK_TO_MAX:
+            // Layer set "GOTO"
+            action->code = ACTION_LAYER_SET(keycode & 0xF, (keycode >> 0x4) & 0x3);
+            break;
+        case QK_MOMENTARY ... QK_MOMENTARY_MAX:
+            action->code = ACTION_LAYER_MOMENTARY(keycode & 0xFF);
+            break;
+        case QK_DEF_LAYER ... QK_DEF_LAYER_MAX:
+            action->code = ACTION_DEFAULT_LAYER_SET(keycode & 0xFF);
+            break;
+        case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX:
+            action->code = ACTION_LAYER_TOGGLE(keycode & 0xFF);
+            break;
+        case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX:
+            // OSL(action_layer) - One-shot action_layer
+            action->code = ACTION_LAYER_ONESHOT(keycode & 0xFF);
+            break;
+        case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX:
+            // OSM(mod) - One-shot mod
+            action->code = ACTION_MODS_ONESHOT(keycode & 0xFF);
+            break;
+        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+            action->code = ACTION_MODS_TAP_KEY((keycode >> 0x8) & 0xF, keycode & 0xFF);
+            break;
+        case 0x7000 ... 0x70FF:
+            // loose quantum keycodes, their values move with the config
+            return false;
+        default:
+            action->code = ACTION_NO;
+            break;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,27 @@
+# Precomputed keymap actions, see quantum/action_table.h
+#
+# The keymap is compiled as usual, then the section holding keymaps[] is
+# copied out of its object with objcopy and decoded on the host by
+# gen_action_table into keymap_actions.c, which is linked with the rest.
+
+HOST_CC ?= cc
+ACTION_TABLE_OBJCOPY ?= $(OBJCOPY)
+
+ACTION_TABLE_GEN := $(KEYMAP_OUTPUT)/gen_action_table
+ACTION_TABLE_BIN := $(KEYMAP_OUTPUT)/keymaps.bin
+ACTION_TABLE_SRC := $(KEYMAP_OUTPUT)/keymap_actions.c
+ACTION_TABLE_KEYMAP_OBJ := $(KEYMAP_OUTPUT)/$(patsubst %.c,%.o,$(KEYMAP_C))
+
+SRC += $(ACTION_TABLE_SRC)
+
+$(ACTION_TABLE_GEN): $(QUANTUM_PATH)/tools/gen_action_table.c $(QUANTUM_PATH)/action_table.h $(QUANTUM_PATH)/keycode_config.h
+	@mkdir -p $(@D)
+	$(HOST_CC) -I$(TMK_PATH)/common -I$(QUANTUM_PATH) $< -o $@
+
+# -fdata-sections puts keymaps[] in .progmem.data.keymaps on AVR and
+# .rodata.keymaps on ARM
+$(ACTION_TABLE_BIN): $(ACTION_TABLE_KEYMAP_OBJ)
+	$(ACTION_TABLE_OBJCOPY) -O binary --only-section='*.keymaps' $< $@
+
+$(ACTION_TABLE_SRC): $(ACTION_TABLE_BIN) $(ACTION_TABLE_GEN)
+	$(ACTION_TABLE_GEN) $< > $@
@@ -0,0 +1,35 @@
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/* Set 0 if debouncing isn't needed */
+#ifndef DEBOUNCING_DELAY
+#   define DEBOUNCING_DELAY 5
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The algorithm is picked at build time with DEBOUNCE_TYPE in rules.mk:
+ *   sym_g           symmetric delay, one timer for the whole matrix (default)
+ *   sym_pk          symmetric delay, one timer per key
+ *   eager_defer_pk  presses reported at once, releases delayed, per key
+ *   eager_pr        both edges reported at once, then held per row
+ */
+void debounce_init(uint8_t num_rows);
+/* Update the debounced matrix from the freshly scanned one.
+ * `changed` is true when `raw` differs from the previous scan.
+ */
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+/* whether some key is still settling */
+bool debounce_active(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef DEBOUNCE_COUNTERS_H
+#define DEBOUNCE_COUNTERS_H
+
+#include <stdint.h>
+#include "timer.h"
+#include "debounce.h"
+
+/* Per-key (or per-row) countdown timers in milliseconds, 0 meaning idle.
+ * With the usual short delays two counters share a byte, so a 100 key board
+ * needs 50 bytes of RAM.
+ */
+#if (DEBOUNCING_DELAY > 254)
+#   error "DEBOUNCING_DELAY: per-key debounce supports at most 254ms"
+#elif (DEBOUNCING_DELAY < 16)
+#   define DEBOUNCE_COUNTER_BITS 4
+#else
+#   define DEBOUNCE_COUNTER_BITS 8
+#endif
+
+#define DEBOUNCE_COUNTERS_SIZE(n) (((n) * DEBOUNCE_COUNTER_BITS + 7) / 8)
+
+static inline uint8_t debounce_counter_get(const uint8_t counters[], uint16_t index)
+{
+#if (DEBOUNCE_COUNTER_BITS == 4)
+    return (counters[index / 2] >> ((index & 1) * 4)) & 0x0F;
+#else
+    return counters[index];
+#endif
+}
+
+static inline void debounce_counter_set(uint8_t counters[], uint16_t index, uint8_t value)
+{
+#if (DEBOUNCE_COUNTER_BITS == 4)
+    const uint8_t shift = (index & 1) * 4;
+    counters[index / 2] = (counters[index / 2] & ~(0x0F << shift)) | (value << shift);
+#else
+    counters[index] = value;
+#endif
+}
+
+/* Count down a running counter, returns true when it has just expired. */
+static inline bool debounce_counter_tick(uint8_t counters[], uint16_t index, uint8_t elapsed)
+{
+    uint8_t value = debounce_counter_get(counters, index);
+    if (value > elapsed) {
+        debounce_counter_set(counters, index, value - elapsed);
+        return false;
+    }
+    debounce_counter_set(counters, index, 0);
+    return true;
+}
+
+/* Whole milliseconds since the previous call, saturated to fit a counter.
+ * Scans faster than the timer resolution report 0 without losing the remainder.
+ */
+static inline uint8_t debounce_elapsed(uint16_t *last_time)
+{
+    uint16_t now = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, *last_time);
+    if (elapsed == 0) {
+        return 0;
+    }
+    *last_time = now;
+    return elapsed > UINT8_MAX ? UINT8_MAX : elapsed;
+}
+
+#endif
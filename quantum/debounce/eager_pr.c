@@ -0,0 +1,50 @@
+/* Eager per-row debounce: a change on a row is reported straight away and
+ * the row is then frozen for DEBOUNCING_DELAY ms while its contacts settle.
+ * Cheaper in RAM than the per-key variants, but keys sharing a row also
+ * share the hold-off.
+ */
+#include "debounce_counters.h"
+
+static uint8_t counters[DEBOUNCE_COUNTERS_SIZE(MATRIX_ROWS)];
+static uint8_t counters_running = 0;
+static uint16_t last_time;
+
+void debounce_init(uint8_t num_rows)
+{
+    for (uint16_t i = 0; i < sizeof(counters); i++) {
+        counters[i] = 0;
+    }
+    counters_running = 0;
+    last_time = timer_read();
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed)
+{
+    uint8_t elapsed = 0;
+    if (counters_running) {
+        elapsed = debounce_elapsed(&last_time);
+    } else {
+        last_time = timer_read();
+        // nothing is held and nothing moved
+        if (!changed) return;
+    }
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        if (debounce_counter_get(counters, row)) {
+            if (!elapsed || !debounce_counter_tick(counters, row, elapsed)) {
+                continue;
+            }
+            counters_running--;
+        }
+        if (raw[row] != cooked[row]) {
+            cooked[row] = raw[row];
+            debounce_counter_set(counters, row, DEBOUNCING_DELAY);
+            counters_running++;
+        }
+    }
+}
+
+bool debounce_active(void)
+{
+    return counters_running;
+}
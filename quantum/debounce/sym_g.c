@@ -0,0 +1,34 @@
+/* Symmetric global debounce: any change restarts a single timer and the
+ * whole matrix is copied once nothing has changed for DEBOUNCING_DELAY ms.
+ * This is the smallest option but one bouncing key holds back every other.
+ */
+#include "timer.h"
+#include "debounce.h"
+
+static bool debouncing = false;
+static uint16_t debouncing_time;
+
+void debounce_init(uint8_t num_rows)
+{
+    debouncing = false;
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed)
+{
+    if (changed) {
+        debouncing = true;
+        debouncing_time = timer_read();
+    }
+
+    if (debouncing && (timer_elapsed(debouncing_time) > DEBOUNCING_DELAY)) {
+        for (uint8_t i = 0; i < num_rows; i++) {
+            cooked[i] = raw[i];
+        }
+        debouncing = false;
+    }
+}
+
+bool debounce_active(void)
+{
+    return debouncing;
+}
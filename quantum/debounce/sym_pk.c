@@ -0,0 +1,72 @@
+/* Symmetric per-key debounce: a key that differs from its debounced state
+ * starts its own timer and is sampled again when it runs out, so a bouncing
+ * key no longer delays the rest of the matrix.
+ */
+#include "debounce_counters.h"
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+static uint8_t counters[DEBOUNCE_COUNTERS_SIZE(MATRIX_ROWS * MATRIX_COLS)];
+static uint16_t counters_running = 0;
+static uint16_t last_time;
+
+void debounce_init(uint8_t num_rows)
+{
+    for (uint16_t i = 0; i < sizeof(counters); i++) {
+        counters[i] = 0;
+    }
+    counters_running = 0;
+    last_time = timer_read();
+}
+
+static void update_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed)
+{
+    uint16_t index = 0;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++, index++) {
+            if (debounce_counter_get(counters, index) == 0) {
+                continue;
+            }
+            if (debounce_counter_tick(counters, index, elapsed)) {
+                counters_running--;
+                matrix_row_t mask = ROW_SHIFTER << col;
+                cooked[row] = (cooked[row] & ~mask) | (raw[row] & mask);
+            }
+        }
+    }
+}
+
+static void start_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows)
+{
+    uint16_t index = 0;
+    for (uint8_t row = 0; row < num_rows; row++, index += MATRIX_COLS) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        for (uint8_t col = 0; delta; col++, delta >>= 1) {
+            if ((delta & 1) && debounce_counter_get(counters, index + col) == 0) {
+                debounce_counter_set(counters, index + col, DEBOUNCING_DELAY);
+                counters_running++;
+            }
+        }
+    }
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed)
+{
+    if (counters_running) {
+        uint8_t elapsed = debounce_elapsed(&last_time);
+        if (elapsed) {
+            update_counters(raw, cooked, num_rows, elapsed);
+        }
+    } else {
+        last_time = timer_read();
+    }
+
+    if (changed) {
+        start_counters(raw, cooked, num_rows);
+    }
+}
+
+bool debounce_active(void)
+{
+    return counters_running;
+}
@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+extern "C" {
+#include "debounce/debounce_counters.h"
+#include "common/test/timer_test.h"
+}
+
+static const uint8_t counter_max = (1 << DEBOUNCE_COUNTER_BITS) - 1;
+
+TEST(DebounceCounters, the_delay_fits_a_counter) {
+    EXPECT_LE(DEBOUNCING_DELAY, counter_max);
+}
+
+TEST(DebounceCounters, neighbouring_counters_dont_overwrite_each_other) {
+    uint8_t counters[DEBOUNCE_COUNTERS_SIZE(9)] = {};
+    for (uint16_t i = 0; i < 9; i++) {
+        debounce_counter_set(counters, i, counter_max - i);
+    }
+    for (uint16_t i = 0; i < 9; i += 2) {
+        debounce_counter_set(counters, i, 0);
+    }
+    for (uint16_t i = 0; i < 9; i++) {
+        EXPECT_EQ(debounce_counter_get(counters, i), i % 2 ? counter_max - i : 0) << "counter " << i;
+    }
+}
+
+TEST(DebounceCounters, a_counter_at_its_maximum_counts_down_to_expiry) {
+    uint8_t counters[DEBOUNCE_COUNTERS_SIZE(2)] = {};
+    debounce_counter_set(counters, 0, counter_max);
+    debounce_counter_set(counters, 1, counter_max);
+    for (int i = 1; i < counter_max; i++) {
+        EXPECT_FALSE(debounce_counter_tick(counters, 1, 1));
+        EXPECT_EQ(debounce_counter_get(counters, 1), counter_max - i);
+    }
+    EXPECT_TRUE(debounce_counter_tick(counters, 1, 1));
+    EXPECT_EQ(debounce_counter_get(counters, 1), 0);
+    EXPECT_EQ(debounce_counter_get(counters, 0), counter_max);
+}
+
+TEST(DebounceCounters, a_tick_longer_than_the_count_expires_it) {
+    uint8_t counters[DEBOUNCE_COUNTERS_SIZE(2)] = {};
+    debounce_counter_set(counters, 1, 3);
+    EXPECT_TRUE(debounce_counter_tick(counters, 1, UINT8_MAX));
+    EXPECT_EQ(debounce_counter_get(counters, 1), 0);
+    EXPECT_EQ(debounce_counter_get(counters, 0), 0);
+}
+
+TEST(DebounceCounters, elapsed_time_saturates_and_keeps_the_remainder) {
+    set_time(100);
+    uint16_t last = timer_read();
+    EXPECT_EQ(debounce_elapsed(&last), 0);
+    advance_time(3);
+    EXPECT_EQ(debounce_elapsed(&last), 3);
+    EXPECT_EQ(debounce_elapsed(&last), 0);
+    advance_time(1000);
+    EXPECT_EQ(debounce_elapsed(&last), UINT8_MAX);
+    advance_time(1);
+    EXPECT_EQ(debounce_elapsed(&last), 1);
+}
@@ -0,0 +1,53 @@
+#ifndef DEBOUNCE_TEST_H
+#define DEBOUNCE_TEST_H
+
+#include "gtest/gtest.h"
+#include <array>
+extern "C" {
+#include "debounce.h"
+#include "common/test/timer_test.h"
+}
+
+/* Runs one debounce algorithm over a matrix the tests press and release keys
+ * in. Every scan is followed by 1ms, like a keyboard scanning at 1kHz. */
+class Debounce : public testing::Test {
+public:
+    Debounce() {
+        set_time(0);
+        raw.fill(0);
+        previous.fill(0);
+        cooked.fill(0);
+        debounce_init(MATRIX_ROWS);
+    }
+
+    void scan() {
+        bool changed = raw != previous;
+        previous = raw;
+        debounce(raw.data(), cooked.data(), MATRIX_ROWS, changed);
+        advance_time(1);
+    }
+
+    void scan_for(int ms) {
+        for (int i = 0; i < ms; i++) {
+            scan();
+        }
+    }
+
+    void press(uint8_t row, uint8_t col) {
+        raw[row] |= (matrix_row_t)1 << col;
+    }
+
+    void release(uint8_t row, uint8_t col) {
+        raw[row] &= ~((matrix_row_t)1 << col);
+    }
+
+    bool is_down(uint8_t row, uint8_t col) {
+        return cooked[row] & ((matrix_row_t)1 << col);
+    }
+
+    std::array<matrix_row_t, MATRIX_ROWS> raw;
+    std::array<matrix_row_t, MATRIX_ROWS> previous;
+    std::array<matrix_row_t, MATRIX_ROWS> cooked;
+};
+
+#endif
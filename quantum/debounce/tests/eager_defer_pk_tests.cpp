@@ -0,0 +1,78 @@
+#include "debounce_test.h"
+
+TEST_F(Debounce, a_press_is_reported_on_the_first_scan) {
+    press(0, 0);
+    scan();
+    EXPECT_TRUE(is_down(0, 0));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, a_release_is_reported_after_the_delay) {
+    press(0, 0);
+    scan_for(10);
+    release(0, 0);
+    scan_for(DEBOUNCING_DELAY);
+    EXPECT_TRUE(is_down(0, 0));
+    EXPECT_TRUE(debounce_active());
+    scan();
+    EXPECT_FALSE(is_down(0, 0));
+}
+
+TEST_F(Debounce, release_chatter_doesnt_release_the_key) {
+    press(1, 2);
+    scan_for(10);
+    for (int i = 0; i < DEBOUNCING_DELAY * 2; i++) {
+        if (i % 2) {
+            press(1, 2);
+        } else {
+            release(1, 2);
+        }
+        scan();
+        EXPECT_TRUE(is_down(1, 2));
+    }
+    scan_for(DEBOUNCING_DELAY * 2);
+    EXPECT_TRUE(is_down(1, 2));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, a_press_during_the_lockout_waits_for_its_end) {
+    press(0, 4);
+    scan();
+    release(0, 4);
+    scan_for(DEBOUNCING_DELAY + 1);
+    EXPECT_FALSE(is_down(0, 4));
+    press(0, 4);
+    scan_for(DEBOUNCING_DELAY - 1);
+    EXPECT_FALSE(is_down(0, 4));
+    EXPECT_TRUE(debounce_active());
+    scan();
+    EXPECT_TRUE(is_down(0, 4));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, a_bounce_during_the_lockout_is_never_reported) {
+    press(0, 4);
+    scan();
+    release(0, 4);
+    scan_for(DEBOUNCING_DELAY + 1);
+    press(0, 4);
+    scan();
+    release(0, 4);
+    scan_for(DEBOUNCING_DELAY * 2);
+    EXPECT_FALSE(is_down(0, 4));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, keys_sharing_a_counter_byte_keep_their_own_time) {
+    press(0, 4);
+    press(1, 0);
+    scan();
+    release(0, 4);
+    scan_for(2);
+    release(1, 0);
+    scan_for(DEBOUNCING_DELAY - 1);
+    EXPECT_FALSE(is_down(0, 4));
+    EXPECT_TRUE(is_down(1, 0));
+    scan_for(2);
+    EXPECT_FALSE(is_down(1, 0));
+}
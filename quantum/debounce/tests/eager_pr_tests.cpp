@@ -0,0 +1,74 @@
+#include "debounce_test.h"
+
+TEST_F(Debounce, a_press_is_reported_on_the_first_scan) {
+    press(0, 0);
+    scan();
+    EXPECT_TRUE(is_down(0, 0));
+    EXPECT_TRUE(debounce_active());
+}
+
+TEST_F(Debounce, the_row_is_held_for_the_delay) {
+    press(0, 0);
+    scan();
+    release(0, 0);
+    scan_for(DEBOUNCING_DELAY - 1);
+    EXPECT_TRUE(is_down(0, 0));
+    scan();
+    EXPECT_FALSE(is_down(0, 0));
+    // the release holds the row again
+    EXPECT_TRUE(debounce_active());
+    scan_for(DEBOUNCING_DELAY);
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, chatter_within_the_hold_is_never_reported) {
+    press(1, 2);
+    scan();
+    for (int i = 0; i < DEBOUNCING_DELAY - 1; i++) {
+        if (i % 2) {
+            press(1, 2);
+        } else {
+            release(1, 2);
+        }
+        scan();
+        EXPECT_TRUE(is_down(1, 2));
+    }
+    press(1, 2);
+    scan_for(DEBOUNCING_DELAY * 2);
+    EXPECT_TRUE(is_down(1, 2));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, a_key_on_the_same_row_waits_for_the_hold) {
+    press(2, 0);
+    scan();
+    press(2, 3);
+    scan_for(DEBOUNCING_DELAY - 1);
+    EXPECT_FALSE(is_down(2, 3));
+    scan();
+    EXPECT_TRUE(is_down(2, 3));
+}
+
+TEST_F(Debounce, a_key_on_another_row_is_reported_at_once) {
+    press(2, 0);
+    scan();
+    press(3, 0);
+    scan();
+    EXPECT_TRUE(is_down(3, 0));
+}
+
+// Row counters are packed two to a byte, rows 2 and 3 share one
+TEST_F(Debounce, rows_sharing_a_counter_byte_keep_their_own_time) {
+    press(2, 0);
+    scan();
+    scan_for(2);
+    press(3, 0);
+    scan();
+    release(2, 0);
+    release(3, 0);
+    scan_for(DEBOUNCING_DELAY - 3);
+    EXPECT_FALSE(is_down(2, 0));
+    EXPECT_TRUE(is_down(3, 0));
+    scan_for(3);
+    EXPECT_FALSE(is_down(3, 0));
+}
@@ -0,0 +1,37 @@
+DEBOUNCE_PATH := $(QUANTUM_PATH)/debounce
+# 5 columns, so keys of neighbouring rows share a byte of nibble counters
+DEBOUNCE_TEST_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=5
+
+debounce_sym_g_SRC := \
+	$(DEBOUNCE_PATH)/tests/sym_g_tests.cpp \
+	$(DEBOUNCE_PATH)/sym_g.c \
+	$(TMK_PATH)/common/test/timer.c
+debounce_sym_g_DEFS := $(DEBOUNCE_TEST_DEFS)
+
+# The longest delay a nibble counter holds
+debounce_sym_pk_SRC := \
+	$(DEBOUNCE_PATH)/tests/sym_pk_tests.cpp \
+	$(DEBOUNCE_PATH)/sym_pk.c \
+	$(TMK_PATH)/common/test/timer.c
+debounce_sym_pk_DEFS := $(DEBOUNCE_TEST_DEFS) -DDEBOUNCING_DELAY=15
+
+debounce_eager_defer_pk_SRC := \
+	$(DEBOUNCE_PATH)/tests/eager_defer_pk_tests.cpp \
+	$(DEBOUNCE_PATH)/eager_defer_pk.c \
+	$(TMK_PATH)/common/test/timer.c
+debounce_eager_defer_pk_DEFS := $(DEBOUNCE_TEST_DEFS)
+
+debounce_eager_pr_SRC := \
+	$(DEBOUNCE_PATH)/tests/eager_pr_tests.cpp \
+	$(DEBOUNCE_PATH)/eager_pr.c \
+	$(TMK_PATH)/common/test/timer.c
+debounce_eager_pr_DEFS := $(DEBOUNCE_TEST_DEFS)
+
+debounce_counters_SRC := \
+	$(DEBOUNCE_PATH)/tests/debounce_counters_tests.cpp \
+	$(TMK_PATH)/common/test/timer.c
+debounce_counters_DEFS := $(DEBOUNCE_TEST_DEFS)
+
+# Delays from 16ms on take a byte per counter
+debounce_counters_8bit_SRC := $(debounce_counters_SRC)
+debounce_counters_8bit_DEFS := $(DEBOUNCE_TEST_DEFS) -DDEBOUNCING_DELAY=200
@@ -0,0 +1,54 @@
+#include "debounce_test.h"
+
+TEST_F(Debounce, a_press_is_reported_once_the_matrix_is_still_for_the_delay) {
+    press(0, 0);
+    scan_for(DEBOUNCING_DELAY + 1);
+    EXPECT_FALSE(is_down(0, 0));
+    EXPECT_TRUE(debounce_active());
+    scan();
+    EXPECT_TRUE(is_down(0, 0));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, a_release_is_reported_once_the_matrix_is_still_for_the_delay) {
+    press(0, 0);
+    scan_for(DEBOUNCING_DELAY + 2);
+    release(0, 0);
+    scan_for(DEBOUNCING_DELAY + 1);
+    EXPECT_TRUE(is_down(0, 0));
+    scan();
+    EXPECT_FALSE(is_down(0, 0));
+}
+
+TEST_F(Debounce, chatter_that_settles_released_is_never_reported) {
+    for (int i = 0; i < 4; i++) {
+        press(1, 2);
+        scan();
+        release(1, 2);
+        scan();
+        EXPECT_FALSE(is_down(1, 2));
+    }
+    scan_for(DEBOUNCING_DELAY * 2);
+    EXPECT_FALSE(is_down(1, 2));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, a_bouncing_key_holds_back_every_other_key) {
+    press(0, 0);
+    for (int i = 0; i < DEBOUNCING_DELAY * 2; i++) {
+        if (i % 2) {
+            release(3, 4);
+        } else {
+            press(3, 4);
+        }
+        scan();
+        EXPECT_FALSE(is_down(0, 0));
+    }
+    scan_for(DEBOUNCING_DELAY + 1);
+    EXPECT_TRUE(is_down(0, 0));
+}
+
+TEST_F(Debounce, nothing_is_active_without_changes) {
+    scan_for(100);
+    EXPECT_FALSE(debounce_active());
+}
@@ -0,0 +1,71 @@
+#include "debounce_test.h"
+
+TEST_F(Debounce, a_press_is_reported_after_the_delay) {
+    press(0, 0);
+    scan_for(DEBOUNCING_DELAY);
+    EXPECT_FALSE(is_down(0, 0));
+    EXPECT_TRUE(debounce_active());
+    scan();
+    EXPECT_TRUE(is_down(0, 0));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, a_release_is_reported_after_the_delay) {
+    press(0, 0);
+    scan_for(DEBOUNCING_DELAY + 1);
+    release(0, 0);
+    scan_for(DEBOUNCING_DELAY);
+    EXPECT_TRUE(is_down(0, 0));
+    scan();
+    EXPECT_FALSE(is_down(0, 0));
+}
+
+TEST_F(Debounce, chatter_that_settles_released_is_never_reported) {
+    for (int i = 0; i < 4; i++) {
+        press(1, 2);
+        scan();
+        release(1, 2);
+        scan();
+    }
+    scan_for(DEBOUNCING_DELAY * 2);
+    EXPECT_FALSE(is_down(1, 2));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, a_bouncing_key_doesnt_hold_back_the_others) {
+    press(0, 0);
+    for (int i = 0; i <= DEBOUNCING_DELAY; i++) {
+        if (i % 2) {
+            release(3, 4);
+        } else {
+            press(3, 4);
+        }
+        scan();
+    }
+    EXPECT_TRUE(is_down(0, 0));
+}
+
+// With 5 columns the last key of a row and the first of the next share a
+// byte of counters, and DEBOUNCING_DELAY fills a whole nibble.
+TEST_F(Debounce, keys_sharing_a_counter_byte_keep_their_own_time) {
+    press(0, 4);
+    scan_for(3);
+    press(1, 0);
+    scan_for(DEBOUNCING_DELAY - 2);
+    EXPECT_TRUE(is_down(0, 4));
+    EXPECT_FALSE(is_down(1, 0));
+    scan_for(2);
+    EXPECT_FALSE(is_down(1, 0));
+    scan();
+    EXPECT_TRUE(is_down(1, 0));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(Debounce, a_long_gap_between_scans_finishes_the_count) {
+    press(2, 3);
+    scan();
+    advance_time(1000);
+    scan();
+    EXPECT_TRUE(is_down(2, 3));
+    EXPECT_FALSE(debounce_active());
+}
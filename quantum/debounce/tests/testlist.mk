@@ -0,0 +1,7 @@
+TEST_LIST +=\
+	debounce_sym_g\
+	debounce_sym_pk\
+	debounce_eager_defer_pk\
+	debounce_eager_pr\
+	debounce_counters\
+	debounce_counters_8bit
@@ -6,6 +6,14 @@
 
 uint16_t keycode_config(uint16_t keycode);
 
+/* keycodes keycode_config() may replace, keep in sync with its switch */
+#define IS_REMAPPABLE_KEYCODE(code) \
+    ((code) == KC_CAPSLOCK || (code) == KC_LOCKING_CAPS || \
+     (code) == KC_LCTL || (code) == KC_LALT || (code) == KC_LGUI || \
+     (code) == KC_RALT || (code) == KC_RGUI || \
+     (code) == KC_GRAVE || (code) == KC_ESC || \
+     (code) == KC_BSLASH || (code) == KC_BSPACE)
+
 /* NOTE: Not portable. Bit field order depends on implementation */
 typedef union {
     uint16_t raw;
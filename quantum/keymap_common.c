@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "debug.h"
 #include "backlight.h"
 #include "quantum.h"
+#include "action_table.h"
 
 #ifdef MIDI_ENABLE
 	#include "process_midi.h"
@@ -40,85 +41,38 @@ extern keymap_config_t keymap_config;
 /* converts key to action */
 action_t action_for_key(uint8_t layer, keypos_t key)
 {
+    action_t action;
+
+#ifdef ACTION_TABLE_ENABLE
+    // precomputed at build time, unless it depends on runtime state
+    const uint16_t index = ((uint16_t)layer * MATRIX_ROWS + key.row) * MATRIX_COLS + key.col;
+    if (index < keymap_actions_count) {
+        action.code = pgm_read_word(&keymap_actions[index]);
+        if (action.code != ACTION_DYNAMIC) {
+            return action;
+        }
+    }
+#endif
+
     // 16bit keycodes - important
     uint16_t keycode = keymap_key_to_keycode(layer, key);
 
     // keycode remapping
     keycode = keycode_config(keycode);
 
-    action_t action;
-    uint8_t action_layer, when, mod;
+    if (keycode_to_static_action(keycode, &action)) {
+        return action;
+    }
 
     switch (keycode) {
         case KC_FN0 ... KC_FN31:
             action.code = keymap_function_id_to_action(FN_INDEX(keycode));
             break;
-        case KC_A ... KC_EXSEL:
-        case KC_LCTRL ... KC_RGUI:
-            action.code = ACTION_KEY(keycode);
-            break;
-        case KC_SYSTEM_POWER ... KC_SYSTEM_WAKE:
-            action.code = ACTION_USAGE_SYSTEM(KEYCODE2SYSTEM(keycode));
-            break;
-        case KC_AUDIO_MUTE ... KC_MEDIA_REWIND:
-            action.code = ACTION_USAGE_CONSUMER(KEYCODE2CONSUMER(keycode));
-            break;
-        case KC_MS_UP ... KC_MS_ACCEL2:
-            action.code = ACTION_MOUSEKEY(keycode);
-            break;
-        case KC_TRNS:
-            action.code = ACTION_TRANSPARENT;
-            break;
-        case QK_MODS ... QK_MODS_MAX: ;
-            // Has a modifier
-            // Split it up
-            action.code = ACTION_MODS_KEY(keycode >> 8, keycode & 0xFF); // adds modifier to key
-            break;
         case QK_FUNCTION ... QK_FUNCTION_MAX: ;
             // Is a shortcut for function action_layer, pull last 12bits
             // This means we have 4,096 FN macros at our disposal
             action.code = keymap_function_id_to_action( (int)keycode & 0xFFF );
             break;
-        case QK_MACRO ... QK_MACRO_MAX:
-            action.code = ACTION_MACRO(keycode & 0xFF);
-            break;
-        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
-            action.code = ACTION_LAYER_TAP_KEY((keycode >> 0x8) & 0xF, keycode & 0xFF);
-            break;
-        case QK_TO ... QK_TO_MAX: ;
-            // Layer set "GOTO"
-            when = (keycode >> 0x4) & 0x3;
-            action_layer = keycode & 0xF;
-            action.code = ACTION_LAYER_SET(action_layer, when);
-            break;
-        case QK_MOMENTARY ... QK_MOMENTARY_MAX: ;
-            // Momentary action_layer
-            action_layer = keycode & 0xFF;
-            action.code = ACTION_LAYER_MOMENTARY(action_layer);
-            break;
-        case QK_DEF_LAYER ... QK_DEF_LAYER_MAX: ;
-            // Set default action_layer
-            action_layer = keycode & 0xFF;
-            action.code = ACTION_DEFAULT_LAYER_SET(action_layer);
-            break;
-        case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX: ;
-            // Set toggle
-            action_layer = keycode & 0xFF;
-            action.code = ACTION_LAYER_TOGGLE(action_layer);
-            break;
-        case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX: ;
-            // OSL(action_layer) - One-shot action_layer
-            action_layer = keycode & 0xFF;
-            action.code = ACTION_LAYER_ONESHOT(action_layer);
-            break;
-        case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX: ;
-            // OSM(mod) - One-shot mod
-            mod = keycode & 0xFF;
-            action.code = ACTION_MODS_ONESHOT(mod);
-            break;
-        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
-            action.code = ACTION_MODS_TAP_KEY((keycode >> 0x8) & 0xF, keycode & 0xFF);
-            break;
     #ifdef BACKLIGHT_ENABLE
         case BL_0 ... BL_15:
             action.code = ACTION_BACKLIGHT_LEVEL(keycode - BL_0);
@@ -143,11 +97,6 @@ action_t action_for_key(uint8_t layer, keypos_t key)
     return action;
 }
 
-__attribute__ ((weak))
-const uint16_t PROGMEM fn_actions[] = {
-
-};
-
 /* Macro */
 __attribute__ ((weak))
 const macro_t *action_get_macro(keyrecord_t *record, uint8_t id, uint8_t opt)
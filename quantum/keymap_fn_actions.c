@@ -0,0 +1,9 @@
+#include "keymap.h"
+
+/* Keymaps without KC_FN* keys don't need a table. This empty default lives
+ * apart from keymap_common.c so keymap_function_id_to_action() isn't compiled
+ * against a zero length array. */
+__attribute__ ((weak))
+const uint16_t PROGMEM fn_actions[] = {
+
+};
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdbool.h>
 #if defined(__AVR__)
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #endif
 #include "wait.h"
 #include "print.h"
@@ -26,18 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "matrix.h"
 #include "timer.h"
-
-
-/* Set 0 if debouncing isn't needed */
-
-#ifndef DEBOUNCING_DELAY
-#   define DEBOUNCING_DELAY 5
-#endif
-
-#if (DEBOUNCING_DELAY > 0)
-    static uint16_t debouncing_time;
-    static bool debouncing = false;
-#endif
+#include "debounce.h"
 
 #if (MATRIX_COLS <= 8)
 #    define print_matrix_header()  print("\nr/c 01234567\n")
@@ -66,8 +56,8 @@ static const uint8_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
 /* matrix state(1:on, 0:off) */
 static matrix_row_t matrix[MATRIX_ROWS];
 
+/* matrix state as read from the pins, before debouncing */
 static matrix_row_t matrix_raw[MATRIX_ROWS];
-static matrix_row_t matrix_debouncing[MATRIX_ROWS];
 
 
 #if (DIODE_DIRECTION == COL2ROW)
@@ -146,6 +136,85 @@ uint8_t matrix_cols(void) {
 // #endif
 // }
 
+#ifdef MATRIX_IDLE_SLEEP
+/* Idle sleep support: with every output line driven low a press of any key
+ * pulls its input line low, so one read of the inputs tells keyboard_task()
+ * whether a full scan is needed. Inputs on port B also get their pin change
+ * interrupt enabled so the press wakes the CPU immediately rather than on the
+ * next timer tick.
+ */
+#if (DIODE_DIRECTION == COL2ROW)
+#   define wakeup_inputs        col_pins
+#   define WAKEUP_INPUT_COUNT   MATRIX_COLS
+#else
+#   define wakeup_inputs        row_pins
+#   define WAKEUP_INPUT_COUNT   MATRIX_ROWS
+#endif
+
+#if defined(PCMSK0) && defined(PCIE0)
+static uint8_t wakeup_pcmsk;
+
+EMPTY_INTERRUPT(PCINT0_vect);
+#endif
+
+void matrix_wakeup_arm(void)
+{
+#if (DIODE_DIRECTION == COL2ROW)
+    for (uint8_t x = 0; x < MATRIX_ROWS; x++) {
+        select_row(x);
+    }
+#else
+    for (uint8_t x = 0; x < MATRIX_COLS; x++) {
+        select_col(x);
+    }
+#endif
+#if defined(PCMSK0) && defined(PCIE0)
+    wakeup_pcmsk = 0;
+    for (uint8_t x = 0; x < WAKEUP_INPUT_COUNT; x++) {
+        uint8_t pin = wakeup_inputs[x];
+        if ((pin & 0xF0) == (B0 & 0xF0)) {
+            wakeup_pcmsk |= _BV(pin & 0xF);
+        }
+    }
+    if (wakeup_pcmsk) {
+        PCMSK0 |= wakeup_pcmsk;
+        PCIFR = _BV(PCIF0);
+        PCICR |= _BV(PCIE0);
+    }
+#endif
+    wait_us(30);
+}
+
+void matrix_wakeup_disarm(void)
+{
+#if defined(PCMSK0) && defined(PCIE0)
+    if (wakeup_pcmsk) {
+        PCMSK0 &= ~wakeup_pcmsk;
+        if (!PCMSK0) {
+            PCICR &= ~_BV(PCIE0);
+        }
+        wakeup_pcmsk = 0;
+    }
+#endif
+#if (DIODE_DIRECTION == COL2ROW)
+    unselect_rows();
+#else
+    unselect_cols();
+#endif
+}
+
+bool matrix_wakeup_pending(void)
+{
+    for (uint8_t x = 0; x < WAKEUP_INPUT_COUNT; x++) {
+        uint8_t pin = wakeup_inputs[x];
+        if (!(_SFR_IO8(pin >> 4) & _BV(pin & 0xF))) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
 void matrix_init(void) {
 
     // To use PORTF disable JTAG with writing JTD bit twice within four cycles.
@@ -167,27 +236,27 @@ void matrix_init(void) {
     for (uint8_t i=0; i < MATRIX_ROWS; i++) {
         matrix[i] = 0;
         matrix_raw[i] = 0;
-        matrix_debouncing[i] = 0;
     }
 
+#if (DEBOUNCING_DELAY > 0)
+    debounce_init(MATRIX_ROWS);
+#endif
+
     matrix_init_quantum();
 }
 
 uint8_t matrix_scan(void)
 {
+#if (DEBOUNCING_DELAY > 0)
+    bool matrix_changed = false;
+#endif
 
 #if (DIODE_DIRECTION == COL2ROW)
 
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < MATRIX_ROWS; current_row++) {
 #       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_cols_on_row(matrix_debouncing, current_row);
-
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
-            }
-
+            matrix_changed |= read_cols_on_row(matrix_raw, current_row);
 #       else
             read_cols_on_row(matrix, current_row);
 #       endif
@@ -199,11 +268,7 @@ uint8_t matrix_scan(void)
     // Set col, read rows
     for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++) {
 #       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_rows_on_col(matrix_debouncing, current_col);
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
-            }
+            matrix_changed |= read_rows_on_col(matrix_raw, current_col);
 #       else
              read_rows_on_col(matrix, current_col);
 #       endif
@@ -213,12 +278,7 @@ uint8_t matrix_scan(void)
 #endif
 
 #   if (DEBOUNCING_DELAY > 0)
-        if (debouncing && (timer_elapsed(debouncing_time) > DEBOUNCING_DELAY)) {
-            for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-                matrix[i] = matrix_debouncing[i];
-            }
-            debouncing = false;
-        }
+        debounce(matrix_raw, matrix, MATRIX_ROWS, matrix_changed);
 #   endif
 
     matrix_scan_quantum();
@@ -228,7 +288,7 @@ uint8_t matrix_scan(void)
 bool matrix_is_modified(void)
 {
 #if (DEBOUNCING_DELAY > 0)
-    if (debouncing) return false;
+    if (debounce_active()) return false;
 #endif
     return true;
 }
@@ -1,4 +1,5 @@
 #include "process_leader.h"
+#include "deadline.h"
 
 __attribute__ ((weak))
 void leader_start(void) {}
@@ -13,26 +14,126 @@ uint16_t leader_time = 0;
 uint16_t leader_sequence[5] = {0, 0, 0, 0, 0};
 uint8_t leader_sequence_size = 0;
 
+/* Leader table
+ *
+ * The entries of the keymap's LEADER_TABLE() are sorted, so the ones starting
+ * with the keys typed so far are a range, and each key narrows that range to
+ * the entries with it at the next position: a step down a trie searched in
+ * place. A range of one complete entry fires at once; an entry that others
+ * extend waits for the next key or the timeout.
+ */
+extern const leader_entry_t leader_table[] __attribute__ ((weak));
+extern const uint16_t leader_table_size __attribute__ ((weak));
+
+/* 0 when the keymap has no table, the weak references are null then */
+static inline uint16_t table_size(void) {
+  return &leader_table_size ? leader_table_size : 0;
+}
+
+static uint16_t table_lo = 0;
+static uint16_t table_hi = 0;
+static uint8_t table_depth = 0;
+
+static inline uint16_t table_key(uint16_t entry, uint8_t depth) {
+  return depth < LEADER_MAX_LENGTH ? pgm_read_word(&leader_table[entry].sequence[depth]) : KC_NO;
+}
+
+/* first entry in [lo, hi) with a key at depth not below keycode */
+static uint16_t table_lower_bound(uint16_t lo, uint16_t hi, uint8_t depth, uint32_t keycode) {
+  while (lo < hi) {
+    uint16_t mid = lo + (hi - lo) / 2;
+    if (table_key(mid, depth) < keycode) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+#ifndef NO_DEBUG
+/* The search can't tell an unsorted table from a missing sequence, it just
+ * never finds some entries. Debug builds check the order once, on the first
+ * leader press, and name the first entry out of place. */
+static void table_check_order(void) {
+  static bool checked = false;
+  if (checked) return;
+  checked = true;
+  for (uint16_t i = 1; i < table_size(); i++) {
+    for (uint8_t depth = 0; depth < LEADER_MAX_LENGTH; depth++) {
+      uint16_t prev = table_key(i - 1, depth);
+      uint16_t key = table_key(i, depth);
+      if (prev < key) break;
+      if (prev > key || key == KC_NO) {
+        xprintf("LEADER_TABLE entry %u isn't sorted, sequences after it may never fire\n", i);
+        return;
+      }
+    }
+  }
+}
+#endif
+
+static void table_finish(bool fire) {
+  leading = false;
+  deadline_cancel(DEADLINE_LEADER);
+  if (fire) {
+    void (*fn)(void) = (void (*)(void))pgm_read_ptr(&leader_table[table_lo].fn);
+    if (fn) fn();
+  }
+  leader_end();
+}
+
+static void table_step(uint16_t keycode) {
+  table_lo = table_lower_bound(table_lo, table_hi, table_depth, keycode);
+  table_hi = table_lower_bound(table_lo, table_hi, table_depth, (uint32_t)keycode + 1);
+  table_depth++;
+
+  if (table_lo == table_hi) {
+    table_finish(false);
+  } else if (table_hi - table_lo == 1 && table_key(table_lo, table_depth) == KC_NO) {
+    table_finish(true);
+  }
+}
+
+void matrix_scan_leader(void) {
+  if (!table_size() || !leading || !deadline_due(DEADLINE_LEADER))
+    return;
+  // a complete entry sorts first in its range
+  table_finish(table_depth && table_key(table_lo, table_depth) == KC_NO);
+}
+
 bool process_leader(uint16_t keycode, keyrecord_t *record) {
   // Leader key set-up
   if (record->event.pressed) {
     if (!leading && keycode == KC_LEAD) {
+#ifndef NO_DEBUG
+      table_check_order();
+#endif
       leader_start();
       leading = true;
       leader_time = timer_read();
+      deadline_set_in(DEADLINE_LEADER, LEADER_TIMEOUT + 1);
       leader_sequence_size = 0;
       leader_sequence[0] = 0;
       leader_sequence[1] = 0;
       leader_sequence[2] = 0;
       leader_sequence[3] = 0;
       leader_sequence[4] = 0;
+      table_lo = 0;
+      table_hi = table_size();
+      table_depth = 0;
       return false;
     }
     if (leading && timer_elapsed(leader_time) < LEADER_TIMEOUT) {
-      leader_sequence[leader_sequence_size] = keycode;
-      leader_sequence_size++;
+      if (leader_sequence_size < 5) {
+        leader_sequence[leader_sequence_size] = keycode;
+        leader_sequence_size++;
+      }
+      if (table_size() && keycode != KC_NO) {
+        table_step(keycode);
+      }
       return false;
     }
   }
   return true;
-}
\ No newline at end of file
+}
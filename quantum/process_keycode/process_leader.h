@@ -17,6 +17,42 @@ void leader_end(void);
 #define SEQ_FOUR_KEYS(key1, key2, key3, key4) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == 0)
 #define SEQ_FIVE_KEYS(key1, key2, key3, key4, key5) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == (key5))
 
+/* Leader table, an alternative to LEADER_DICTIONARY() in matrix_scan_user()
+ *
+ *   LEADER_TABLE(
+ *     LEADER_SEQ(leader_copy, KC_C),
+ *     LEADER_SEQ(leader_cut, KC_C, KC_X),
+ *     LEADER_SEQ(leader_email, KC_E, KC_M),
+ *   );
+ *
+ * Entries have to be sorted by their keycodes, a shorter sequence before the
+ * ones extending it, and each sequence listed once. Nothing sorts them: out
+ * of order entries are silently never matched, only a debug build reports
+ * the first one on the first leader press.
+ *
+ * A sequence fires on its last key unless a longer one starts with it, then
+ * on LEADER_TIMEOUT. It can be up to LEADER_MAX_LENGTH keys long.
+ */
+#ifndef LEADER_MAX_LENGTH
+  #define LEADER_MAX_LENGTH 8
+#endif
+
+typedef struct {
+  uint16_t sequence[LEADER_MAX_LENGTH];
+  void (*fn)(void);
+} leader_entry_t;
+
+#define LEADER_SEQ(action, ...) { .sequence = { __VA_ARGS__ }, .fn = (action) }
+#define LEADER_TABLE(...) \
+  const leader_entry_t leader_table[] PROGMEM = { __VA_ARGS__ }; \
+  const uint16_t leader_table_size = sizeof(leader_table) / sizeof(leader_table[0])
+
+extern const leader_entry_t leader_table[];
+extern const uint16_t leader_table_size;
+
+/* runs the table on LEADER_TIMEOUT */
+void matrix_scan_leader(void);
+
 #define LEADER_EXTERNS() extern bool leading; extern uint16_t leader_time; extern uint16_t leader_sequence[5]; extern uint8_t leader_sequence_size
 #define LEADER_DICTIONARY() if (leading && timer_elapsed(leader_time) > LEADER_TIMEOUT)
 
@@ -1,8 +1,18 @@
 #include "quantum.h"
 #include "action_tapping.h"
+#include "deadline.h"
+
+#ifndef TAP_DANCE_MAX_ACTIVE
+#define TAP_DANCE_MAX_ACTIVE 8
+#endif
 
 static uint16_t last_td;
-static int8_t highest_td = -1;
+
+/* Dances with a count, the only ones scans and other keys look at. One more
+ * than can be started over the ones still held, a full set finishes the new
+ * dance right away. */
+static uint8_t active_td[TAP_DANCE_MAX_ACTIVE];
+static uint8_t active_count = 0;
 
 void qk_tap_dance_pair_finished (qk_tap_dance_state_t *state, void *user_data) {
   qk_tap_dance_pair_t *pair = (qk_tap_dance_pair_t *)user_data;
@@ -55,6 +65,72 @@ static inline void process_tap_dance_action_on_reset (qk_tap_dance_action_t *act
   send_keyboard_report();
 }
 
+static bool tap_dance_activate (uint8_t idx)
+{
+  for (uint8_t i = 0; i < active_count; i++) {
+    if (active_td[i] == idx)
+      return true;
+  }
+  if (active_count == TAP_DANCE_MAX_ACTIVE)
+    return false;
+  active_td[active_count++] = idx;
+  return true;
+}
+
+static void tap_dance_deactivate (uint8_t idx)
+{
+  for (uint8_t i = 0; i < active_count; i++) {
+    if (active_td[i] == idx) {
+      active_td[i] = active_td[--active_count];
+      return;
+    }
+  }
+}
+
+static inline uint16_t tap_dance_term (qk_tap_dance_action_t *action)
+{
+  if (action->custom_tapping_term)
+    return action->custom_tapping_term;
+  return KEYCODE_TAPPING_TERM(action->state.keycode);
+}
+
+/* wake for the first dance whose term runs out */
+static void tap_dance_schedule (void)
+{
+  bool waiting = false;
+  uint16_t next = 0;
+
+  for (uint8_t i = 0; i < active_count; i++) {
+    qk_tap_dance_action_t *action = &tap_dance_actions[active_td[i]];
+    if (action->state.finished)
+      continue;
+    uint16_t elapsed = timer_elapsed (action->state.timer);
+    uint16_t term = tap_dance_term (action);
+    uint16_t left = elapsed > term ? 0 : term + 1 - elapsed;
+    if (!waiting || left < next)
+      next = left;
+    waiting = true;
+  }
+
+  if (waiting)
+    deadline_set_in(DEADLINE_TAP_DANCE, next);
+  else
+    deadline_cancel(DEADLINE_TAP_DANCE);
+}
+
+/* finish and reset every active dance, in reverse as reset drops them */
+static void tap_dance_interrupt_all (void)
+{
+  for (int8_t i = active_count - 1; i >= 0; i--) {
+    if (i >= active_count)
+      continue;
+    qk_tap_dance_action_t *action = &tap_dance_actions[active_td[i]];
+    action->state.interrupted = true;
+    process_tap_dance_action_on_dance_finished (action);
+    reset_tap_dance (&action->state);
+  }
+}
+
 bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
   uint16_t idx = keycode - QK_TAP_DANCE;
   qk_tap_dance_action_t *action;
@@ -65,8 +141,6 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
   switch(keycode) {
   case QK_TAP_DANCE ... QK_TAP_DANCE_MAX:
-    if ((int16_t)idx > highest_td)
-      highest_td = idx;
     action = &tap_dance_actions[idx];
 
     action->state.pressed = record->event.pressed;
@@ -85,7 +159,16 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
       }
 
       last_td = keycode;
+
+      // no more taps can change the outcome
+      if (!tap_dance_activate (idx) ||
+          (action->max_count && action->state.count >= action->max_count)) {
+        process_tap_dance_action_on_dance_finished (action);
+      }
+    } else if (action->state.finished) {
+      reset_tap_dance (&action->state);
     }
+    tap_dance_schedule ();
 
     break;
 
@@ -93,17 +176,11 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
     if (!record->event.pressed)
       return true;
 
-    if (highest_td == -1)
+    if (!active_count)
       return true;
 
-    for (int i = 0; i <= highest_td; i++) {
-      action = &tap_dance_actions[i];
-      if (action->state.count == 0)
-        continue;
-      action->state.interrupted = true;
-      process_tap_dance_action_on_dance_finished (action);
-      reset_tap_dance (&action->state);
-    }
+    tap_dance_interrupt_all ();
+    tap_dance_schedule ();
     break;
   }
 
@@ -111,17 +188,22 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 }
 
 void matrix_scan_tap_dance () {
-  if (highest_td == -1)
+  if (!active_count || !deadline_due(DEADLINE_TAP_DANCE))
     return;
 
-for (int i = 0; i <= highest_td; i++) {
-    qk_tap_dance_action_t *action = &tap_dance_actions[i];
+  for (int8_t i = active_count - 1; i >= 0; i--) {
+    if (i >= active_count)
+      continue;
+    qk_tap_dance_action_t *action = &tap_dance_actions[active_td[i]];
 
-    if (action->state.count && timer_elapsed (action->state.timer) > TAPPING_TERM) {
+    if (!action->state.finished && timer_elapsed (action->state.timer) > tap_dance_term (action)) {
       process_tap_dance_action_on_dance_finished (action);
       reset_tap_dance (&action->state);
     }
   }
+
+  // held dances reset on release
+  tap_dance_schedule ();
 }
 
 void reset_tap_dance (qk_tap_dance_state_t *state) {
@@ -138,4 +220,5 @@ void reset_tap_dance (qk_tap_dance_state_t *state) {
   state->interrupted = false;
   state->finished = false;
   last_td = 0;
+  tap_dance_deactivate (state->keycode - QK_TAP_DANCE);
 }
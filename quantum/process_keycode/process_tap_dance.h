@@ -30,6 +30,10 @@ typedef struct
   } fn;
   qk_tap_dance_state_t state;
   void *user_data;
+  /* tapping term of this dance, 0 for the keycode's */
+  uint16_t custom_tapping_term;
+  /* finish as soon as count reaches this, 0 to always wait out the term */
+  uint8_t max_count;
 } qk_tap_dance_action_t;
 
 typedef struct
@@ -43,6 +47,19 @@ typedef struct
     .user_data = (void *)&((qk_tap_dance_pair_t) { kc1, kc2 }),  \
   }
 
+#define ACTION_TAP_DANCE_DOUBLE_TIME(kc1, kc2, tap_specific_tapping_term) { \
+    .fn = { NULL, qk_tap_dance_pair_finished, qk_tap_dance_pair_reset }, \
+    .user_data = (void *)&((qk_tap_dance_pair_t) { kc1, kc2 }),  \
+    .custom_tapping_term = tap_specific_tapping_term, \
+  }
+
+/* the second tap sends kc2 right away, there is nothing left to wait for */
+#define ACTION_TAP_DANCE_DOUBLE_MAX(kc1, kc2) { \
+    .fn = { NULL, qk_tap_dance_pair_finished, qk_tap_dance_pair_reset }, \
+    .user_data = (void *)&((qk_tap_dance_pair_t) { kc1, kc2 }),  \
+    .max_count = 2, \
+  }
+
 #define ACTION_TAP_DANCE_FN(user_fn) {  \
     .fn = { NULL, user_fn, NULL }, \
     .user_data = NULL, \
@@ -53,6 +70,12 @@ typedef struct
     .user_data = NULL, \
   }
 
+#define ACTION_TAP_DANCE_FN_ADVANCED_TIME(user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset, tap_specific_tapping_term) { \
+    .fn = { user_fn_on_each_tap, user_fn_on_dance_finished, user_fn_on_dance_reset }, \
+    .user_data = NULL, \
+    .custom_tapping_term = tap_specific_tapping_term, \
+  }
+
 extern qk_tap_dance_action_t tap_dance_actions[];
 
 /* To be used internally */
@@ -1,4 +1,9 @@
 #include "quantum.h"
+#include "deadline.h"
+
+#ifndef DISABLE_LEADER
+extern bool leading;
+#endif
 
 #ifndef TAPPING_TERM
 #define TAPPING_TERM 200
@@ -58,6 +63,58 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
   return true;
 }
 
+#ifdef TAPPING_TERM_PER_KEY
+__attribute__ ((weak))
+uint16_t get_tapping_term_user(uint16_t keycode) {
+  return TAPPING_TERM;
+}
+
+__attribute__ ((weak))
+uint16_t get_tapping_term_kb(uint16_t keycode) {
+  return get_tapping_term_user(keycode);
+}
+#endif
+
+#ifdef PERMISSIVE_HOLD_PER_KEY
+__attribute__ ((weak))
+bool get_permissive_hold_user(uint16_t keycode) {
+  return false;
+}
+
+__attribute__ ((weak))
+bool get_permissive_hold_kb(uint16_t keycode) {
+  return get_permissive_hold_user(keycode);
+}
+#endif
+
+#ifdef HOLD_ON_OTHER_KEY_PRESS_PER_KEY
+__attribute__ ((weak))
+bool get_hold_on_other_key_press_user(uint16_t keycode) {
+  return false;
+}
+
+__attribute__ ((weak))
+bool get_hold_on_other_key_press_kb(uint16_t keycode) {
+  return get_hold_on_other_key_press_user(keycode);
+}
+#endif
+
+#if defined(TAPPING_TERM_PER_KEY) || defined(PERMISSIVE_HOLD_PER_KEY) || defined(HOLD_ON_OTHER_KEY_PRESS_PER_KEY)
+// called once per tap key press, the hooks all get the keycode it was pressed as
+void get_tapping_settings(keypos_t key, tapping_settings_t *settings) {
+  uint16_t keycode = keymap_key_to_keycode(layer_switch_get_layer(key), key);
+  #ifdef TAPPING_TERM_PER_KEY
+    settings->term = get_tapping_term_kb(keycode);
+  #endif
+  #ifdef PERMISSIVE_HOLD_PER_KEY
+    settings->permissive_hold = get_permissive_hold_kb(keycode);
+  #endif
+  #ifdef HOLD_ON_OTHER_KEY_PRESS_PER_KEY
+    settings->hold_on_other_key_press = get_hold_on_other_key_press_kb(keycode);
+  #endif
+}
+#endif
+
 void reset_keyboard(void) {
   clear_keyboard();
 #ifdef AUDIO_ENABLE
@@ -83,27 +140,10 @@ void reset_keyboard(void) {
 static bool shift_interrupted[2] = {0, 0};
 static uint16_t scs_timer = 0;
 
-bool process_record_quantum(keyrecord_t *record) {
-
-  /* This gets the keycode from the key pressed */
-  keypos_t key = record->event.key;
-  uint16_t keycode;
-
-  #if !defined(NO_ACTION_LAYER) && defined(PREVENT_STUCK_MODIFIERS)
-    /* TODO: Use store_or_get_action() or a similar function. */
-    if (!disable_action_cache) {
-      uint8_t layer;
+bool process_record_quantum(keyrecord_t *record, keylookup_t *lookup) {
 
-      if (record->event.pressed) {
-        layer = layer_switch_get_layer(key);
-        update_source_layers_cache(key, layer);
-      } else {
-        layer = read_source_layers_cache(key);
-      }
-      keycode = keymap_key_to_keycode(layer, key);
-    } else
-  #endif
-    keycode = keymap_key_to_keycode(layer_switch_get_layer(key), key);
+  /* This gets the keycode from the key pressed, resolved once by process_record() */
+  uint16_t keycode = lookup->keycode;
 
     // This is how you use actions here
     // if (keycode == KC_LEAD) {
@@ -303,7 +343,7 @@ bool process_record_quantum(keyrecord_t *record) {
             shift_interrupted[1] = true;
           }
         #endif
-        if (!shift_interrupted[0] && timer_elapsed(scs_timer) < TAPPING_TERM) {
+        if (!shift_interrupted[0] && timer_elapsed(scs_timer) < KEYCODE_TAPPING_TERM(KC_LSPO)) {
           register_code(LSPO_KEY);
           unregister_code(LSPO_KEY);
         }
@@ -326,7 +366,7 @@ bool process_record_quantum(keyrecord_t *record) {
             shift_interrupted[1] = true;
           }
         #endif
-        if (!shift_interrupted[1] && timer_elapsed(scs_timer) < TAPPING_TERM) {
+        if (!shift_interrupted[1] && timer_elapsed(scs_timer) < KEYCODE_TAPPING_TERM(KC_RSPC)) {
           register_code(RSPC_KEY);
           unregister_code(RSPC_KEY);
         }
@@ -427,7 +467,18 @@ const uint8_t ascii_to_colemak_keycode_lut[0x80] PROGMEM = {
 
 #endif
 
+#ifdef NONBLOCKING_MACROS
+bool macro_ascii_to_keycode(uint8_t ascii, uint8_t *keycode) {
+    *keycode = pgm_read_byte(&ascii_to_qwerty_keycode_lut[ascii]);
+    return pgm_read_byte(&ascii_to_qwerty_shift_lut[ascii]);
+}
+#endif
+
 void send_string(const char *str) {
+#ifdef NONBLOCKING_MACROS
+    // typed a report at a time from keyboard_task()
+    action_macro_send_string(str);
+#else
     while (1) {
         uint8_t keycode;
         uint8_t ascii_code = pgm_read_byte(str);
@@ -445,6 +496,7 @@ void send_string(const char *str) {
         }
         ++str;
     }
+#endif
 }
 
 void update_tri_layer(uint8_t layer1, uint8_t layer2, uint8_t layer3) {
@@ -500,7 +552,15 @@ void matrix_init_quantum() {
   matrix_init_kb();
 }
 
+#ifdef SCAN_THREAD
+// matrix_scan() runs in the scan thread, this belongs with keyboard_task()
 void matrix_scan_quantum() {
+}
+
+void keyboard_task_quantum(void) {
+#else
+void matrix_scan_quantum() {
+#endif
   #ifdef AUDIO_ENABLE
     matrix_scan_music();
   #endif
@@ -508,9 +568,39 @@ void matrix_scan_quantum() {
   #ifdef TAP_DANCE_ENABLE
     matrix_scan_tap_dance();
   #endif
+
+  #ifndef DISABLE_LEADER
+    matrix_scan_leader();
+  #endif
   matrix_scan_kb();
+
+  #ifndef DISABLE_LEADER
+    // the table or the dictionary in matrix_scan_user ends the sequence
+    if (!leading)
+      deadline_cancel(DEADLINE_LEADER);
+  #endif
+}
+
+#ifdef MATRIX_IDLE_SLEEP
+__attribute__ ((weak))
+bool keyboard_idle_user(void) {
+  return true;
 }
 
+__attribute__ ((weak))
+bool keyboard_idle_kb(void) {
+  return keyboard_idle_user();
+}
+
+// keep scanning while anything here still runs off timer_read() without a deadline
+bool keyboard_idle_quantum(void) {
+  #ifdef AUDIO_ENABLE
+    if (is_playing_notes()) return false;
+  #endif
+  return keyboard_idle_kb();
+}
+#endif
+
 #if defined(BACKLIGHT_ENABLE) && defined(BACKLIGHT_PIN)
 
 static const uint8_t backlight_pin = BACKLIGHT_PIN;
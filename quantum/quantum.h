@@ -24,6 +24,7 @@
 #include "config_common.h"
 #include "led.h"
 #include "action_util.h"
+#include "action_tapping.h"
 #include <stdlib.h>
 #include "print.h"
 
@@ -82,11 +83,30 @@ bool process_action_kb(keyrecord_t *record);
 bool process_record_kb(uint16_t keycode, keyrecord_t *record);
 bool process_record_user(uint16_t keycode, keyrecord_t *record);
 
+#ifdef TAPPING_TERM_PER_KEY
+uint16_t get_tapping_term_kb(uint16_t keycode);
+uint16_t get_tapping_term_user(uint16_t keycode);
+#define KEYCODE_TAPPING_TERM(keycode) get_tapping_term_kb(keycode)
+#else
+#define KEYCODE_TAPPING_TERM(keycode) TAPPING_TERM
+#endif
+#ifdef PERMISSIVE_HOLD_PER_KEY
+bool get_permissive_hold_kb(uint16_t keycode);
+bool get_permissive_hold_user(uint16_t keycode);
+#endif
+#ifdef HOLD_ON_OTHER_KEY_PRESS_PER_KEY
+bool get_hold_on_other_key_press_kb(uint16_t keycode);
+bool get_hold_on_other_key_press_user(uint16_t keycode);
+#endif
+
 void reset_keyboard(void);
 
 void startup_user(void);
 void shutdown_user(void);
 
+bool keyboard_idle_kb(void);
+bool keyboard_idle_user(void);
+
 void register_code16 (uint16_t code);
 void unregister_code16 (uint16_t code);
 
@@ -3,6 +3,7 @@
 #include <util/delay.h>
 #include "progmem.h"
 #include "timer.h"
+#include "deadline.h"
 #include "rgblight.h"
 #include "debug.h"
 
@@ -233,6 +234,7 @@ void rgblight_mode(uint8_t mode) {
   }
   eeconfig_update_rgblight(rgblight_config.raw);
   xprintf("rgblight mode: %u\n", rgblight_config.mode);
+  deadline_cancel(DEADLINE_RGBLIGHT);
   if (rgblight_config.mode == 1) {
     #ifdef RGBLIGHT_ANIMATIONS
       rgblight_timer_disable();
@@ -419,6 +421,8 @@ void rgblight_timer_enable(void) {
 }
 void rgblight_timer_disable(void) {
   rgblight_timer_enabled = false;
+  // a due deadline nobody reschedules would keep the keyboard awake
+  deadline_cancel(DEADLINE_RGBLIGHT);
   dprintf("TIMER3 disabled.\n");
 }
 void rgblight_timer_toggle(void) {
@@ -433,6 +437,10 @@ void rgblight_show_solid_color(uint8_t r, uint8_t g, uint8_t b) {
 }
 
 void rgblight_task(void) {
+  // the running effect schedules its next step
+  if (deadline_pending(DEADLINE_RGBLIGHT) && !deadline_due(DEADLINE_RGBLIGHT)) {
+    return;
+  }
   if (rgblight_timer_enabled) {
     // mode = 1, static light, do nothing here
     if (rgblight_config.mode >= 2 && rgblight_config.mode <= 5) {
@@ -466,6 +474,7 @@ void rgblight_effect_breathing(uint8_t interval) {
     return;
   }
   last_timer = timer_read();
+  deadline_set_in(DEADLINE_RGBLIGHT, pgm_read_byte(&RGBLED_BREATHING_INTERVALS[interval]));
 
   rgblight_sethsv_noeeprom(rgblight_config.hue, rgblight_config.sat, pgm_read_byte(&RGBLED_BREATHING_TABLE[pos]));
   pos = (pos + 1) % 256;
@@ -478,6 +487,7 @@ void rgblight_effect_rainbow_mood(uint8_t interval) {
     return;
   }
   last_timer = timer_read();
+  deadline_set_in(DEADLINE_RGBLIGHT, pgm_read_byte(&RGBLED_RAINBOW_MOOD_INTERVALS[interval]));
   rgblight_sethsv_noeeprom(current_hue, rgblight_config.sat, rgblight_config.val);
   current_hue = (current_hue + 1) % 360;
 }
@@ -490,6 +500,7 @@ void rgblight_effect_rainbow_swirl(uint8_t interval) {
     return;
   }
   last_timer = timer_read();
+  deadline_set_in(DEADLINE_RGBLIGHT, pgm_read_byte(&RGBLED_RAINBOW_MOOD_INTERVALS[interval / 2]));
   for (i = 0; i < RGBLED_NUM; i++) {
     hue = (360 / RGBLED_NUM * i + current_hue) % 360;
     sethsv(hue, rgblight_config.sat, rgblight_config.val, (LED_TYPE *)&led[i]);
@@ -519,6 +530,7 @@ void rgblight_effect_snake(uint8_t interval) {
     return;
   }
   last_timer = timer_read();
+  deadline_set_in(DEADLINE_RGBLIGHT, pgm_read_byte(&RGBLED_SNAKE_INTERVALS[interval / 2]));
   for (i = 0; i < RGBLED_NUM; i++) {
     led[i].r = 0;
     led[i].g = 0;
@@ -555,6 +567,7 @@ void rgblight_effect_knight(uint8_t interval) {
     return;
   }
   last_timer = timer_read();
+  deadline_set_in(DEADLINE_RGBLIGHT, pgm_read_byte(&RGBLED_KNIGHT_INTERVALS[interval]));
   for (i = 0; i < RGBLED_NUM; i++) {
     preled[i].r = 0;
     preled[i].g = 0;
@@ -608,6 +621,7 @@ void rgblight_effect_christmas(void) {
     return;
   }
   last_timer = timer_read();
+  deadline_set_in(DEADLINE_RGBLIGHT, 1000);
   current_offset = (current_offset + 1) % 2;
   for (i = 0; i < RGBLED_NUM; i++) {
     hue = 0 + ((RGBLED_NUM * (i + current_offset)) % 2) * 80;
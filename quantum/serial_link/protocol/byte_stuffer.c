@@ -53,8 +53,7 @@ void init_byte_stuffer(void) {
     }
 }
 
-void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
-    byte_stuffer_state_t* state = &states[link];
+static inline void recv_byte(uint8_t link, byte_stuffer_state_t* state, uint8_t data) {
     // Start of a new frame
     if (state->next_zero == 0) {
         state->next_zero = data;
@@ -102,41 +101,82 @@ void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
     }
 }
 
-static void send_block(uint8_t link, uint8_t* start, uint8_t* end, uint8_t num_non_zero) {
-    send_data(link, &num_non_zero, 1);
-    if (end > start) {
-        send_data(link, start, end-start);
+void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
+    recv_byte(link, &states[link], data);
+}
+
+void byte_stuffer_recv_data(uint8_t link, const uint8_t* data, uint16_t size) {
+    byte_stuffer_state_t* state = &states[link];
+    const uint8_t* end = data + size;
+    while (data < end) {
+        // Inside a block every byte before the next length byte is plain
+        // data, so copy that run in one go
+        if (state->next_zero > 1) {
+            uint16_t run = state->next_zero - 1;
+            uint16_t available = end - data;
+            uint16_t room = MAX_FRAME_SIZE - state->data_pos;
+            if (run > available) {
+                run = available;
+            }
+            if (run > room) {
+                run = room;
+            }
+            uint8_t* out = state->data + state->data_pos;
+            uint16_t i;
+            // A zero inside a block is an error, recv_byte deals with it
+            for (i = 0; i < run && data[i] != 0; i++) {
+                out[i] = data[i];
+            }
+            state->data_pos += i;
+            state->next_zero -= i;
+            data += i;
+            if (data == end) {
+                break;
+            }
+        }
+        recv_byte(link, state, *data++);
     }
 }
 
+// COBS adds a length byte per 254 bytes, plus the first one and the terminator
+#define MAX_ENCODED_SIZE (MAX_FRAME_SIZE + MAX_FRAME_SIZE / 254 + 2)
+
+static uint8_t send_buffer[MAX_ENCODED_SIZE];
+
+// Encodes the whole frame into send_buffer in one pass, so that the physical
+// layer gets it with a single send_data call. Frames that wouldn't fit in
+// send_buffer are dropped, the receiver couldn't take them either.
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
-    const uint8_t zero = 0;
+    if (size > MAX_FRAME_SIZE) {
+        return;
+    }
     if (size > 0) {
-        uint16_t num_non_zero = 1;
         uint8_t* end = data + size;
-        uint8_t* start = data;
+        uint8_t* out = send_buffer;
+        uint8_t* length = out++;
+        uint8_t num_non_zero = 1;
         while (data < end) {
             if (num_non_zero == 0xFF) {
                 // There's more data after big non-zero block
-                // So send it, and start a new block
-                send_block(link, start, data, num_non_zero);
-                start = data;
+                // So close it, and start a new block
+                *length = num_non_zero;
+                length = out++;
+                num_non_zero = 1;
+            }
+            if (*data == 0) {
+                // A zero encountered, so close the block
+                *length = num_non_zero;
+                length = out++;
                 num_non_zero = 1;
             }
             else {
-                if (*data == 0) {
-                    // A zero encountered, so send the block
-                    send_block(link, start, data, num_non_zero);
-                    start = data + 1;
-                    num_non_zero = 1;
-                }
-                else {
-                    num_non_zero++;
-                }
-                ++data;
+                *out++ = *data;
+                num_non_zero++;
             }
+            ++data;
         }
-        send_block(link, start, data, num_non_zero);
-        send_data(link, &zero, 1);
+        *length = num_non_zero;
+        *out++ = 0;
+        send_data(link, send_buffer, out - send_buffer);
     }
 }
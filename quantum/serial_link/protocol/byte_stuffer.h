@@ -32,6 +32,8 @@ SOFTWARE.
 
 void init_byte_stuffer(void);
 void byte_stuffer_recv_byte(uint8_t link, uint8_t data);
+// Same as calling byte_stuffer_recv_byte for each byte, but faster
+void byte_stuffer_recv_data(uint8_t link, const uint8_t* data, uint16_t size);
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size);
 
 #endif
@@ -0,0 +1,43 @@
+#ifndef SERIAL_LINK_CRC_H
+#define SERIAL_LINK_CRC_H
+
+#include <stdint.h>
+
+/* Frame checksums
+ *
+ * Every frame carries a checksum of its payload, appended by the frame
+ * validator. Both halves of a split keyboard have to agree on it, so pick
+ * the same option in both config.h files:
+ *
+ *   (default)                     CRC-32, slice-by-4, 4 KB of tables
+ *   SERIAL_LINK_CRC32_SLICE_BY_8  CRC-32, slice-by-8, 8 KB of tables
+ *   SERIAL_LINK_CRC32_HARDWARE    CRC-32 from the MCU's CRC unit, the
+ *                                 platform supplies crc32_hardware()
+ *   SERIAL_LINK_CRC16             CRC-16/CCITT-FALSE, 512 bytes of table and
+ *                                 a 2 byte trailer, enough for short frames
+ *
+ * All CRC-32 variants give the standard (zlib/Ethernet) value, a hardware
+ * unit has to be set up to reflect its input and output and xor the result.
+ */
+
+uint32_t crc32_bytewise(const uint8_t* data, uint16_t size);
+uint32_t crc32_slice_by_4(const uint8_t* data, uint16_t size);
+uint32_t crc32_slice_by_8(const uint8_t* data, uint16_t size);
+uint32_t crc32_hardware(const uint8_t* data, uint16_t size);
+uint16_t crc16_ccitt(const uint8_t* data, uint16_t size);
+
+#if defined(SERIAL_LINK_CRC16)
+#define SERIAL_LINK_CRC_SIZE 2
+#define serial_link_crc(data, size) crc16_ccitt(data, size)
+#elif defined(SERIAL_LINK_CRC32_HARDWARE)
+#define SERIAL_LINK_CRC_SIZE 4
+#define serial_link_crc(data, size) crc32_hardware(data, size)
+#elif defined(SERIAL_LINK_CRC32_SLICE_BY_8)
+#define SERIAL_LINK_CRC_SIZE 4
+#define serial_link_crc(data, size) crc32_slice_by_8(data, size)
+#else
+#define SERIAL_LINK_CRC_SIZE 4
+#define serial_link_crc(data, size) crc32_slice_by_4(data, size)
+#endif
+
+#endif
@@ -28,7 +28,8 @@ SOFTWARE.
 #include <stdint.h>
 
 void validator_recv_frame(uint8_t link, uint8_t* data, uint16_t size);
-// The buffer pointed to by the data needs 4 additional bytes
+// The buffer pointed to by the data needs 4 additional bytes, see crc.h for
+// the checksum options
 void validator_send_frame(uint8_t link, uint8_t* data, uint16_t size);
 
 #endif
@@ -0,0 +1,60 @@
+#include "serial_link/protocol/key_events.h"
+#include <string.h>
+
+void key_events_sender_init(key_events_sender_t* sender) {
+    reliable_sender_init(&sender->sender);
+    memset(sender->queued, 0, sizeof(sender->queued));
+}
+
+void key_events_queue(key_events_sender_t* sender, const matrix_row_t* matrix) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t changed = matrix[row] ^ sender->queued[row];
+        for (uint8_t col = 0; changed; col++, changed >>= 1) {
+            if (changed & 1) {
+                matrix_row_t bit = (matrix_row_t)1 << col;
+                reliable_event_t event = row * MATRIX_COLS + col;
+                if (matrix[row] & bit) {
+                    event |= KEY_EVENT_PRESSED;
+                }
+                if (!reliable_sender_push(&sender->sender, event)) {
+                    return;
+                }
+                sender->queued[row] ^= bit;
+            }
+        }
+    }
+}
+
+void key_events_receiver_init(key_events_receiver_t* receiver) {
+    reliable_receiver_init(&receiver->receiver);
+    memset(receiver->rows, 0, sizeof(receiver->rows));
+}
+
+bool key_events_receive(key_events_receiver_t* receiver, const reliable_window_t* window, reliable_ack_t* ack) {
+    bool changed = false;
+    if (window->flags & RELIABLE_WINDOW_SYNC) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            changed |= receiver->rows[row] != 0;
+            receiver->rows[row] = 0;
+        }
+    }
+    reliable_event_t events[SERIAL_LINK_RELIABLE_WINDOW];
+    uint8_t num_events = reliable_receive(&receiver->receiver, window, events, ack);
+    for (uint8_t i = 0; i < num_events; i++) {
+        uint8_t key = events[i] & 0xFF;
+        if (key >= MATRIX_ROWS * MATRIX_COLS) {
+            continue;
+        }
+        matrix_row_t* row = &receiver->rows[key / MATRIX_COLS];
+        matrix_row_t bit = (matrix_row_t)1 << (key % MATRIX_COLS);
+        matrix_row_t old = *row;
+        if (events[i] & KEY_EVENT_PRESSED) {
+            *row |= bit;
+        }
+        else {
+            *row &= ~bit;
+        }
+        changed |= *row != old;
+    }
+    return changed;
+}
@@ -0,0 +1,43 @@
+#ifndef SERIAL_LINK_KEY_EVENTS_H
+#define SERIAL_LINK_KEY_EVENTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+#include "serial_link/protocol/reliable_channel.h"
+
+/* Key presses and releases over a reliable channel
+ *
+ * Each event is row * MATRIX_COLS + col, with KEY_EVENT_PRESSED set for a
+ * press. The sender only queues the edges that fit in its window, the rest
+ * wait in the matrix for the next update. A sender that restarts can't know
+ * what it had reported pressed, so the receiver releases every key when one
+ * asks to sync and the new sender reports its pressed keys again.
+ */
+
+#define KEY_EVENT_PRESSED 0x100
+
+#if MATRIX_ROWS * MATRIX_COLS > 256
+#error "Key event indices don't fit in a byte"
+#endif
+
+typedef struct {
+    reliable_sender_t sender;
+    // The matrix described by the events queued so far
+    matrix_row_t queued[MATRIX_ROWS];
+} key_events_sender_t;
+
+typedef struct {
+    reliable_receiver_t receiver;
+    matrix_row_t rows[MATRIX_ROWS];
+} key_events_receiver_t;
+
+void key_events_sender_init(key_events_sender_t* sender);
+void key_events_queue(key_events_sender_t* sender, const matrix_row_t* matrix);
+
+void key_events_receiver_init(key_events_receiver_t* receiver);
+// Applies the window to receiver->rows and fills the ack to send back,
+// returns true if the rows changed
+bool key_events_receive(key_events_receiver_t* receiver, const reliable_window_t* window, reliable_ack_t* ack);
+
+#endif
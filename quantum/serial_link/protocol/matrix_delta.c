@@ -0,0 +1,66 @@
+#include "serial_link/protocol/matrix_delta.h"
+#include <stddef.h>
+#include <string.h>
+
+void matrix_delta_init(matrix_delta_state_t* state) {
+    memset(state, 0, sizeof(*state));
+}
+
+void matrix_delta_take_snapshot(matrix_delta_state_t* state, const matrix_row_t* rows, matrix_snapshot_t* snapshot) {
+    if (state->has_snapshot) {
+        state->snapshot.sequence++;
+    }
+    state->has_snapshot = true;
+    memcpy(state->snapshot.rows, rows, sizeof(state->snapshot.rows));
+    memcpy(state->rows, rows, sizeof(state->rows));
+    *snapshot = state->snapshot;
+}
+
+bool matrix_delta_diff(const matrix_delta_state_t* state, const matrix_row_t* rows, matrix_delta_t* delta) {
+    if (!state->has_snapshot) {
+        return false;
+    }
+    delta->snapshot = state->snapshot.sequence;
+    delta->num_keys = 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t changed = rows[row] ^ state->snapshot.rows[row];
+        for (uint8_t col = 0; changed; col++, changed >>= 1) {
+            if (changed & 1) {
+                if (delta->num_keys == SERIAL_LINK_DELTA_KEYS) {
+                    return false;
+                }
+                delta->keys[delta->num_keys++] = row * MATRIX_COLS + col;
+            }
+        }
+    }
+    return true;
+}
+
+uint16_t matrix_delta_size(const void* delta) {
+    const matrix_delta_t* d = (const matrix_delta_t*)delta;
+    return offsetof(matrix_delta_t, keys) + d->num_keys;
+}
+
+void matrix_delta_apply_snapshot(matrix_delta_state_t* state, const matrix_snapshot_t* snapshot) {
+    state->has_snapshot = true;
+    state->snapshot = *snapshot;
+    memcpy(state->rows, snapshot->rows, sizeof(state->rows));
+}
+
+bool matrix_delta_apply(matrix_delta_state_t* state, const matrix_delta_t* delta) {
+    if (!state->has_snapshot || delta->snapshot != state->snapshot.sequence ||
+            delta->num_keys > SERIAL_LINK_DELTA_KEYS) {
+        return false;
+    }
+    matrix_row_t rows[MATRIX_ROWS];
+    memcpy(rows, state->snapshot.rows, sizeof(rows));
+    for (uint8_t i = 0; i < delta->num_keys; i++) {
+        uint8_t key = delta->keys[i];
+        if (key >= MATRIX_ROWS * MATRIX_COLS) {
+            return false;
+        }
+        rows[key / MATRIX_COLS] ^= (matrix_row_t)1 << (key % MATRIX_COLS);
+    }
+    memcpy(state->rows, rows, sizeof(state->rows));
+    return true;
+}
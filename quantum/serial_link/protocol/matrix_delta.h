@@ -0,0 +1,58 @@
+#ifndef SERIAL_LINK_MATRIX_DELTA_H
+#define SERIAL_LINK_MATRIX_DELTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/* Matrix updates as snapshots and deltas
+ *
+ * A snapshot carries every row and a sequence number. A delta lists the keys
+ * that differ from one snapshot, so it's idempotent: a newer delta replaces
+ * an older one, which is what the latest value transport objects give us.
+ * A delta whose snapshot never arrived is ignored until the next snapshot,
+ * so the sender should take one periodically to resync.
+ */
+
+// Keys a delta can hold before a new snapshot is needed
+#ifndef SERIAL_LINK_DELTA_KEYS
+#define SERIAL_LINK_DELTA_KEYS 8
+#endif
+
+#if MATRIX_ROWS * MATRIX_COLS > 256
+#error "Matrix delta key indices don't fit in a byte"
+#endif
+
+typedef struct {
+    uint8_t sequence;
+    matrix_row_t rows[MATRIX_ROWS];
+} matrix_snapshot_t;
+
+typedef struct {
+    uint8_t snapshot;
+    uint8_t num_keys;
+    // row * MATRIX_COLS + col of each key that has toggled
+    uint8_t keys[SERIAL_LINK_DELTA_KEYS];
+} matrix_delta_t;
+
+typedef struct {
+    bool has_snapshot;
+    matrix_snapshot_t snapshot;
+    matrix_row_t rows[MATRIX_ROWS];
+} matrix_delta_state_t;
+
+void matrix_delta_init(matrix_delta_state_t* state);
+
+// Sender side
+void matrix_delta_take_snapshot(matrix_delta_state_t* state, const matrix_row_t* rows, matrix_snapshot_t* snapshot);
+// Returns false when the keys don't fit and a snapshot has to be taken instead
+bool matrix_delta_diff(const matrix_delta_state_t* state, const matrix_row_t* rows, matrix_delta_t* delta);
+// The bytes of the delta that need to be sent
+uint16_t matrix_delta_size(const void* delta);
+
+// Receiver side, the current matrix is in state->rows
+void matrix_delta_apply_snapshot(matrix_delta_state_t* state, const matrix_snapshot_t* snapshot);
+// Returns false if the delta doesn't belong to the current snapshot
+bool matrix_delta_apply(matrix_delta_state_t* state, const matrix_delta_t* delta);
+
+#endif
@@ -25,6 +25,7 @@ SOFTWARE.
 #ifndef SERIAL_LINK_PHYSICAL_H
 #define SERIAL_LINK_PHYSICAL_H
 
+// Called once per frame with the complete encoded frame
 void send_data(uint8_t link, const uint8_t* data, uint16_t size);
 
 #endif
@@ -0,0 +1,92 @@
+#include "serial_link/protocol/reliable_channel.h"
+#include <stddef.h>
+#include <string.h>
+
+void reliable_sender_init(reliable_sender_t* sender) {
+    memset(sender, 0, sizeof(*sender));
+    // Ask to sync right away, the receiver learns of the restart from it
+    sender->unsent = true;
+}
+
+bool reliable_sender_push(reliable_sender_t* sender, reliable_event_t event) {
+    if (sender->num_events == SERIAL_LINK_RELIABLE_WINDOW) {
+        return false;
+    }
+    sender->events[sender->num_events++] = event;
+    sender->unsent = true;
+    return true;
+}
+
+void reliable_sender_ack(reliable_sender_t* sender, const reliable_ack_t* ack) {
+    if (!sender->synced) {
+        // Whatever the receiver expects is where our numbering starts
+        sender->synced = true;
+        sender->first = ack->next;
+        sender->unsent = sender->num_events > 0;
+        return;
+    }
+    uint8_t acked = ack->next - sender->first;
+    if (acked == 0 || acked > sender->num_events) {
+        return;
+    }
+    sender->num_events -= acked;
+    memmove(sender->events, sender->events + acked, sender->num_events * sizeof(reliable_event_t));
+    sender->first = ack->next;
+}
+
+bool reliable_sender_poll(reliable_sender_t* sender, uint16_t now, reliable_window_t* window) {
+    if (sender->synced && sender->num_events == 0) {
+        return false;
+    }
+    if (!sender->unsent && (uint16_t)(now - sender->last_send) < SERIAL_LINK_RETRANSMIT_INTERVAL) {
+        return false;
+    }
+    sender->unsent = false;
+    sender->last_send = now;
+    window->first = sender->first;
+    if (sender->synced) {
+        window->flags = 0;
+        window->num_events = sender->num_events;
+        memcpy(window->events, sender->events, sender->num_events * sizeof(reliable_event_t));
+    }
+    else {
+        window->flags = RELIABLE_WINDOW_SYNC;
+        window->num_events = 0;
+    }
+    return true;
+}
+
+uint16_t reliable_window_size(const void* window) {
+    const reliable_window_t* w = (const reliable_window_t*)window;
+    return offsetof(reliable_window_t, events) + w->num_events * sizeof(reliable_event_t);
+}
+
+void reliable_receiver_init(reliable_receiver_t* receiver) {
+    memset(receiver, 0, sizeof(*receiver));
+}
+
+uint8_t reliable_receive(reliable_receiver_t* receiver, const reliable_window_t* window,
+        reliable_event_t* events, reliable_ack_t* ack) {
+    uint8_t num_events = 0;
+    if (!receiver->synced) {
+        receiver->synced = true;
+        receiver->next = window->first;
+    }
+    if (!(window->flags & RELIABLE_WINDOW_SYNC) && window->num_events <= SERIAL_LINK_RELIABLE_WINDOW) {
+        int8_t delivered = receiver->next - window->first;
+        if (delivered < 0) {
+            // The sender is ahead of us, nothing we can do about the missing
+            // events but to carry on from its window
+            delivered = 0;
+        }
+        for (uint8_t i = delivered; i < window->num_events; i++) {
+            events[num_events++] = window->events[i];
+        }
+        // An old window leaves next where it was
+        if (delivered < window->num_events) {
+            receiver->next = window->first + window->num_events;
+        }
+    }
+    ack->next = receiver->next;
+    return num_events;
+}
@@ -0,0 +1,78 @@
+#ifndef SERIAL_LINK_RELIABLE_CHANNEL_H
+#define SERIAL_LINK_RELIABLE_CHANNEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Reliable channel for events
+ *
+ * The remote objects only keep the latest value, which is right for state
+ * but loses events. Here the sender keeps every event until it's
+ * acknowledged, and each window it sends holds all of them, numbered from
+ * the sequence number of the first. So a newer window replaces an older one
+ * without losing anything, and the receiver delivers each event exactly once.
+ *
+ * The acknowledgement is the next sequence number the receiver expects,
+ * which also tells the sender what to resend. There is no separate NAK, a
+ * frame that fails its CRC can't tell which object it was. Unacknowledged
+ * windows are resent after SERIAL_LINK_RETRANSMIT_INTERVAL ms.
+ *
+ * A sender starts out unsynced and asks for the receiver's next sequence
+ * number before sending events, so either side can restart on its own. It
+ * asks even without events, so that the receiver hears about the restart.
+ */
+
+// Events the sender can hold before they are acknowledged
+#ifndef SERIAL_LINK_RELIABLE_WINDOW
+#define SERIAL_LINK_RELIABLE_WINDOW 16
+#endif
+
+#ifndef SERIAL_LINK_RETRANSMIT_INTERVAL
+#define SERIAL_LINK_RETRANSMIT_INTERVAL 5
+#endif
+
+#define RELIABLE_WINDOW_SYNC 1
+
+typedef uint16_t reliable_event_t;
+
+typedef struct {
+    uint8_t flags;
+    uint8_t first;
+    uint8_t num_events;
+    reliable_event_t events[SERIAL_LINK_RELIABLE_WINDOW];
+} reliable_window_t;
+
+typedef struct {
+    uint8_t next;
+} reliable_ack_t;
+
+typedef struct {
+    bool synced;
+    bool unsent;
+    uint8_t first;
+    uint8_t num_events;
+    uint16_t last_send;
+    reliable_event_t events[SERIAL_LINK_RELIABLE_WINDOW];
+} reliable_sender_t;
+
+typedef struct {
+    bool synced;
+    uint8_t next;
+} reliable_receiver_t;
+
+void reliable_sender_init(reliable_sender_t* sender);
+// Returns false if the window is full
+bool reliable_sender_push(reliable_sender_t* sender, reliable_event_t event);
+void reliable_sender_ack(reliable_sender_t* sender, const reliable_ack_t* ack);
+// Fills the window and returns true when it should be sent, now is in ms
+bool reliable_sender_poll(reliable_sender_t* sender, uint16_t now, reliable_window_t* window);
+// The bytes of the window that need to be sent
+uint16_t reliable_window_size(const void* window);
+
+void reliable_receiver_init(reliable_receiver_t* receiver);
+// Copies the events not delivered before to events and returns how many,
+// ack should be sent back even when there are none
+uint8_t reliable_receive(reliable_receiver_t* receiver, const reliable_window_t* window,
+    reliable_event_t* events, reliable_ack_t* ack);
+
+#endif
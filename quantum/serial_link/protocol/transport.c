@@ -77,7 +77,11 @@ void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size) {
     uint8_t id = data[size-1];
     if (id < num_remote_objects) {
         remote_object_t* obj = remote_objects[id];
-        if (obj->object_size == size - 1) {
+        bool size_ok = obj->object_size == size - 1;
+        if (obj->frame_size) {
+            size_ok = size > 1 && size - 1 <= obj->object_size;
+        }
+        if (size_ok) {
             uint8_t* start;
             if (obj->object_type == MASTER_TO_ALL_SLAVES) {
                 start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
@@ -97,6 +101,10 @@ void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size) {
     }
 }
 
+static uint16_t frame_size(remote_object_t* obj, const void* ptr) {
+    return obj->frame_size ? obj->frame_size(ptr) : obj->object_size;
+}
+
 void update_transport(void) {
     unsigned int i;
     for(i=0;i<num_remote_objects;i++) {
@@ -105,9 +113,10 @@ void update_transport(void) {
             triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer;
             uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size + LOCAL_OBJECT_EXTRA, tb);
             if (ptr) {
-                ptr[obj->object_size] = i;
+                uint16_t size = frame_size(obj, ptr);
+                ptr[size] = i;
                 uint8_t dest = obj->object_type == MASTER_TO_ALL_SLAVES ? 0xFF : 0;
-                router_send_frame(dest, ptr, obj->object_size + 1);
+                router_send_frame(dest, ptr, size + 1);
             }
         }
         else {
@@ -117,9 +126,10 @@ void update_transport(void) {
                 triple_buffer_object_t* tb = (triple_buffer_object_t*)start;
                 uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size + LOCAL_OBJECT_EXTRA, tb);
                 if (ptr) {
-                    ptr[obj->object_size] = i;
+                    uint16_t size = frame_size(obj, ptr);
+                    ptr[size] = i;
                     uint8_t dest = j + 1;
-                    router_send_frame(dest, ptr, obj->object_size + 1);
+                    router_send_frame(dest, ptr, size + 1);
                 }
                 start += LOCAL_OBJECT_SIZE(obj->object_size);
             }
@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include "serial_link/protocol/triple_buffered_object.h"
 #include "serial_link/system/serial_link.h"
+#include <stddef.h>
 
 #define NUM_SLAVES 8
 #define LOCAL_OBJECT_EXTRA 16
@@ -43,6 +44,9 @@ typedef enum {
 typedef struct {
     remote_object_type object_type;
     uint16_t object_size;
+    // Optional, returns how much of the object needs to be sent, the receiver
+    // then accepts any frame up to object_size
+    uint16_t (*frame_size)(const void* object);
     uint8_t buffer[] __attribute__((aligned(4)));
 } remote_object_t;
 
@@ -116,11 +120,16 @@ typedef struct { \
     }
 
 #define SLAVE_TO_MASTER_OBJECT(name, type) \
+    SLAVE_TO_MASTER_VARIABLE_OBJECT(name, type, NULL)
+
+// Like SLAVE_TO_MASTER_OBJECT, but only frame_size(object) bytes are sent
+#define SLAVE_TO_MASTER_VARIABLE_OBJECT(name, type, size_function) \
     REMOTE_OBJECT_HELPER(name, type, 1, NUM_SLAVES) \
     remote_object_##name##_t remote_object_##name = { \
         .object = { \
             .object_type = SLAVE_TO_MASTER, \
             .object_size = sizeof(type), \
+            .frame_size = size_function, \
         } \
     }; \
     type* begin_write_##name(void) { \
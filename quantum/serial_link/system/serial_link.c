@@ -23,14 +23,19 @@ SOFTWARE.
 */
 #include "report.h"
 #include "host_driver.h"
+#include "host.h"
 #include "serial_link/system/serial_link.h"
 #include "hal.h"
 #include "serial_link/protocol/byte_stuffer.h"
 #include "serial_link/protocol/transport.h"
 #include "serial_link/protocol/frame_router.h"
+#include "serial_link/protocol/matrix_delta.h"
+#include "serial_link/protocol/key_events.h"
 #include "matrix.h"
 #include <stdbool.h>
+#include <string.h>
 #include "print.h"
+#include "timer.h"
 #include "config.h"
 
 static event_source_t new_data_event;
@@ -60,22 +65,33 @@ host_driver_t serial_driver = {
 #error "Serial link thread priority not set"
 #endif
 
+// How often the matrix delta and the connected flag are resent, in ms, which
+// also repairs a lost delta
+#ifndef SERIAL_LINK_HEARTBEAT_INTERVAL
+#define SERIAL_LINK_HEARTBEAT_INTERVAL 10
+#endif
+
+// How often a full matrix snapshot is sent for resync, in ms
+#ifndef SERIAL_LINK_SNAPSHOT_INTERVAL
+#define SERIAL_LINK_SNAPSHOT_INTERVAL 50
+#endif
+
 static SerialConfig config = {
     .sc_speed = SERIAL_LINK_BAUD
 };
 
 //#define DEBUG_LINK_ERRORS
 
+// How much is taken out of the input queue at a time, half of the queue lets
+// the interrupt keep filling the other half while this is decoded
+#ifndef SERIAL_LINK_RX_CHUNK_SIZE
+#define SERIAL_LINK_RX_CHUNK_SIZE (SERIAL_BUFFERS_SIZE / 2)
+#endif
+
 static uint32_t read_from_serial(SerialDriver* driver, uint8_t link) {
-    const uint32_t buffer_size = 16;
-    uint8_t buffer[buffer_size];
-    uint32_t bytes_read = sdAsynchronousRead(driver, buffer, buffer_size);
-    uint8_t* current = buffer;
-    uint8_t* end = current + bytes_read;
-    while(current < end) {
-        byte_stuffer_recv_byte(link, *current);
-        current++;
-    }
+    uint8_t buffer[SERIAL_LINK_RX_CHUNK_SIZE];
+    uint32_t bytes_read = sdAsynchronousRead(driver, buffer, sizeof(buffer));
+    byte_stuffer_recv_data(link, buffer, bytes_read);
     return bytes_read;
 }
 
@@ -168,24 +184,50 @@ void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
     }
 }
 
-static systime_t last_update = 0;
-
-typedef struct {
-    matrix_row_t rows[MATRIX_ROWS];
-} matrix_object_t;
+static systime_t last_heartbeat = 0;
+static matrix_row_t last_matrix[MATRIX_ROWS] = {};
 
-static matrix_object_t last_matrix = {};
+#ifndef SERIAL_LINK_RELIABLE_KEYS
+static systime_t last_snapshot = 0;
+// What we have sent, and what we have received from the first slave
+static matrix_delta_state_t local_matrix;
+static matrix_delta_state_t remote_matrix;
+#endif
 
-SLAVE_TO_MASTER_OBJECT(keyboard_matrix, matrix_object_t);
+// The snapshot has to come before the delta, so that both sent in the same
+// update arrive in order
+SLAVE_TO_MASTER_OBJECT(keyboard_matrix, matrix_snapshot_t);
+SLAVE_TO_MASTER_VARIABLE_OBJECT(keyboard_matrix_delta, matrix_delta_t, matrix_delta_size);
 MASTER_TO_ALL_SLAVES_OBJECT(serial_link_connected, bool);
 
+#ifdef SERIAL_LINK_RELIABLE_KEYS
+// Key presses and releases from the first slave, each sent until acknowledged
+static key_events_sender_t key_sender;
+static key_events_receiver_t key_receiver;
+
+SLAVE_TO_MASTER_VARIABLE_OBJECT(key_events, reliable_window_t, reliable_window_size);
+MASTER_TO_SINGLE_SLAVE_OBJECT(key_events_ack, reliable_ack_t);
+#endif
+
 static remote_object_t* remote_objects[] = {
     REMOTE_OBJECT(serial_link_connected),
     REMOTE_OBJECT(keyboard_matrix),
+    REMOTE_OBJECT(keyboard_matrix_delta),
+#ifdef SERIAL_LINK_RELIABLE_KEYS
+    REMOTE_OBJECT(key_events),
+    REMOTE_OBJECT(key_events_ack),
+#endif
 };
 
 void init_serial_link(void) {
     serial_link_connected = false;
+#ifdef SERIAL_LINK_RELIABLE_KEYS
+    key_events_sender_init(&key_sender);
+    key_events_receiver_init(&key_receiver);
+#else
+    matrix_delta_init(&local_matrix);
+    matrix_delta_init(&remote_matrix);
+#endif
     init_serial_link_hal();
     add_remote_objects(remote_objects, sizeof(remote_objects)/sizeof(remote_object_t*));
     init_byte_stuffer();
@@ -198,36 +240,92 @@ void init_serial_link(void) {
 
 void matrix_set_remote(matrix_row_t* rows, uint8_t index);
 
+#ifndef SERIAL_LINK_RELIABLE_KEYS
+static void send_matrix(matrix_row_t* matrix, systime_t current_time) {
+    matrix_delta_t delta;
+    bool snapshot_due = current_time - last_snapshot > MS2ST(SERIAL_LINK_SNAPSHOT_INTERVAL);
+    if (snapshot_due || !matrix_delta_diff(&local_matrix, matrix, &delta)) {
+        last_snapshot = current_time;
+        matrix_delta_take_snapshot(&local_matrix, matrix, begin_write_keyboard_matrix());
+        end_write_keyboard_matrix();
+    }
+    else {
+        *begin_write_keyboard_matrix_delta() = delta;
+        end_write_keyboard_matrix_delta();
+    }
+}
+
+static void receive_matrix(void) {
+    bool updated = false;
+    matrix_snapshot_t* snapshot = read_keyboard_matrix(0);
+    if (snapshot) {
+        matrix_delta_apply_snapshot(&remote_matrix, snapshot);
+        updated = true;
+    }
+    matrix_delta_t* delta = read_keyboard_matrix_delta(0);
+    if (delta) {
+        updated |= matrix_delta_apply(&remote_matrix, delta);
+    }
+    if (updated) {
+        matrix_set_remote(remote_matrix.rows, 0);
+    }
+}
+
+#else
+static void update_key_events(matrix_row_t* matrix) {
+    reliable_ack_t* ack = read_key_events_ack();
+    if (ack) {
+        reliable_sender_ack(&key_sender.sender, ack);
+    }
+    key_events_queue(&key_sender, matrix);
+    reliable_window_t window;
+    if (reliable_sender_poll(&key_sender.sender, timer_read(), &window)) {
+        *begin_write_key_events() = window;
+        end_write_key_events();
+    }
+
+    reliable_window_t* received = read_key_events(0);
+    if (received) {
+        bool changed = key_events_receive(&key_receiver, received, begin_write_key_events_ack(0));
+        end_write_key_events_ack(0);
+        if (changed) {
+            matrix_set_remote(key_receiver.rows, 0);
+        }
+    }
+}
+#endif
+
 void serial_link_update(void) {
     if (read_serial_link_connected()) {
         serial_link_connected = true;
     }
 
-    matrix_object_t matrix;
+    matrix_row_t matrix[MATRIX_ROWS];
     bool changed = false;
     for(uint8_t i=0;i<MATRIX_ROWS;i++) {
-        matrix.rows[i] = matrix_get_row(i);
-        changed |= matrix.rows[i] != last_matrix.rows[i];
+        matrix[i] = matrix_get_row(i);
+        changed |= matrix[i] != last_matrix[i];
     }
 
     systime_t current_time = chVTGetSystemTimeX();
-    systime_t delta = current_time - last_update;
-    if (changed || delta > US2ST(1000)) {
-        last_update = current_time;
-        last_matrix = matrix;
-        matrix_object_t* m = begin_write_keyboard_matrix();
-        for(uint8_t i=0;i<MATRIX_ROWS;i++) {
-            m->rows[i] = matrix.rows[i];
+    bool heartbeat = current_time - last_heartbeat > MS2ST(SERIAL_LINK_HEARTBEAT_INTERVAL);
+    if (changed || heartbeat) {
+        memcpy(last_matrix, matrix, sizeof(last_matrix));
+#ifndef SERIAL_LINK_RELIABLE_KEYS
+        send_matrix(matrix, current_time);
+#endif
+        if (heartbeat) {
+            last_heartbeat = current_time;
+            *begin_write_serial_link_connected() = true;
+            end_write_serial_link_connected();
         }
-        end_write_keyboard_matrix();
-        *begin_write_serial_link_connected() = true;
-        end_write_serial_link_connected();
     }
 
-    matrix_object_t* m = read_keyboard_matrix(0);
-    if (m) {
-        matrix_set_remote(m->rows, 0);
-    }
+#ifdef SERIAL_LINK_RELIABLE_KEYS
+    update_key_events(matrix);
+#else
+    receive_matrix();
+#endif
 }
 
 void signal_data_written(void) {
@@ -249,6 +347,9 @@ uint8_t keyboard_leds(void) {
 
 void send_keyboard(report_keyboard_t *report) {
     (void)report;
+#ifdef KEYBOARD_REPORT_QUEUE
+    host_keyboard_sent();
+#endif
 }
 
 void send_mouse(report_mouse_t *report) {
@@ -51,8 +51,10 @@ public:
 
     void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
         std::copy(data, data + size, std::back_inserter(sent_data));
+        num_sends++;
     }
     std::vector<uint8_t> sent_data;
+    int num_sends = 0;
 
     static ByteStuffer* Instance;
 };
@@ -415,6 +417,35 @@ TEST_F(ByteStuffer, sends_frame_with_254_non_zeroes_followed_by_zero) {
     EXPECT_THAT(sent_data, ElementsAreArray(expected));
 }
 
+TEST_F(ByteStuffer, sends_a_long_frame_with_a_single_send_data_call) {
+    uint8_t data[600];
+    int i;
+    for(i=0;i<600;i++) {
+        data[i] = i % 7;
+    }
+    byte_stuffer_send_frame(0, data, 600);
+    EXPECT_EQ(num_sends, 1);
+}
+
+TEST_F(ByteStuffer, sends_maximum_size_frame_of_non_zeroes) {
+    uint8_t data[MAX_FRAME_SIZE];
+    int i;
+    for(i=0;i<MAX_FRAME_SIZE;i++) {
+        data[i] = 0x55;
+    }
+    byte_stuffer_send_frame(0, data, MAX_FRAME_SIZE);
+    // a length byte per 254 bytes and the terminator
+    EXPECT_EQ(sent_data.size(), MAX_FRAME_SIZE + (MAX_FRAME_SIZE + 253) / 254 + 1);
+    EXPECT_EQ(sent_data.back(), 0);
+}
+
+TEST_F(ByteStuffer, sends_nothing_for_a_frame_larger_than_the_maximum) {
+    uint8_t data[MAX_FRAME_SIZE + 1] = {};
+    byte_stuffer_send_frame(0, data, sizeof(data));
+    EXPECT_EQ(num_sends, 0);
+    EXPECT_TRUE(sent_data.empty());
+}
+
 TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_small_packet) {
     uint8_t original_data[] = { 1, 2, 3};
     byte_stuffer_send_frame(0, original_data, sizeof(original_data));
@@ -481,3 +512,79 @@ TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_254_bytes_and_then_zero) {
        byte_stuffer_recv_byte(1, d);
     }
 }
+
+TEST_F(ByteStuffer, receives_a_frame_passed_in_one_buffer) {
+    uint8_t original_data[600];
+    for (unsigned i = 0; i < sizeof(original_data); i++) {
+        original_data[i] = i % 100;
+    }
+    byte_stuffer_send_frame(0, original_data, sizeof(original_data));
+    EXPECT_CALL(*this, validator_recv_frame(1, _, _))
+        .With(Args<1, 2>(ElementsAreArray(original_data)));
+    byte_stuffer_recv_data(1, sent_data.data(), sent_data.size());
+}
+
+TEST_F(ByteStuffer, receives_several_frames_split_across_buffers) {
+    uint8_t frame1[] = {1, 2, 0, 3};
+    uint8_t frame2[300];
+    for (unsigned i = 0; i < sizeof(frame2); i++) {
+        frame2[i] = i + 1;
+    }
+    byte_stuffer_send_frame(0, frame1, sizeof(frame1));
+    byte_stuffer_send_frame(0, frame2, sizeof(frame2));
+    testing::InSequence s;
+    EXPECT_CALL(*this, validator_recv_frame(0, _, _))
+        .With(Args<1, 2>(ElementsAreArray(frame1)));
+    EXPECT_CALL(*this, validator_recv_frame(0, _, _))
+        .With(Args<1, 2>(ElementsAreArray(frame2)));
+    for (size_t i = 0; i < sent_data.size(); i += 7) {
+        byte_stuffer_recv_data(0, sent_data.data() + i, std::min<size_t>(7, sent_data.size() - i));
+    }
+}
+
+TEST_F(ByteStuffer, receives_any_stream_in_chunks_like_byte_at_a_time) {
+    uint32_t state = 1;
+    auto random = [&state]() {
+        state = state * 1103515245 + 12345;
+        return (uint8_t)(state >> 16);
+    };
+    for (int i = 0; i < 200; i++) {
+        std::vector<uint8_t> frame(1 + random() + random());
+        for (auto& d : frame) {
+            uint8_t r = random();
+            d = r < 25 ? 0 : r;
+        }
+        byte_stuffer_send_frame(0, frame.data(), frame.size());
+    }
+    // Corrupt some of the bytes, so that there are broken frames too
+    std::vector<uint8_t> stream = sent_data;
+    for (auto& d : stream) {
+        if (random() < 2) {
+            d = random() < 128 ? 0 : random();
+        }
+    }
+    // A block that never ends overflows the frame
+    stream.insert(stream.end(), MAX_FRAME_SIZE + 10, 0xFF);
+    stream.push_back(0);
+
+    std::vector<std::vector<uint8_t>>* frames;
+    EXPECT_CALL(*this, validator_recv_frame(0, _, _))
+        .WillRepeatedly(testing::Invoke([&frames](uint8_t, uint8_t* data, uint16_t size) {
+            frames->emplace_back(data, data + size);
+        }));
+    std::vector<std::vector<uint8_t>> expected;
+    frames = &expected;
+    for (auto d : stream) {
+        byte_stuffer_recv_byte(0, d);
+    }
+    EXPECT_GT(expected.size(), 50u);
+    for (size_t chunk : {1, 3, 16, 64, 255, 1000}) {
+        init_byte_stuffer();
+        std::vector<std::vector<uint8_t>> actual;
+        frames = &actual;
+        for (size_t i = 0; i < stream.size(); i += chunk) {
+            byte_stuffer_recv_data(0, stream.data() + i, std::min(chunk, stream.size() - i));
+        }
+        EXPECT_EQ(actual, expected) << "chunk " << chunk;
+    }
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include <chrono>
+#include <cstdio>
+extern "C" {
+#include "serial_link/protocol/crc.h"
+}
+
+static const uint8_t check_data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+static std::vector<uint8_t> pseudo_random_data(size_t size) {
+    std::vector<uint8_t> data(size);
+    uint32_t state = 0x12345678;
+    for (auto& d : data) {
+        state = state * 1103515245 + 12345;
+        d = state >> 24;
+    }
+    return data;
+}
+
+TEST(Crc, crc32_bytewise_gives_the_check_value) {
+    EXPECT_EQ(crc32_bytewise(check_data, sizeof(check_data)), 0xCBF43926);
+}
+
+TEST(Crc, crc32_slice_by_4_gives_the_check_value) {
+    EXPECT_EQ(crc32_slice_by_4(check_data, sizeof(check_data)), 0xCBF43926);
+}
+
+TEST(Crc, crc32_slice_by_8_gives_the_check_value) {
+    EXPECT_EQ(crc32_slice_by_8(check_data, sizeof(check_data)), 0xCBF43926);
+}
+
+TEST(Crc, crc16_ccitt_gives_the_check_value) {
+    EXPECT_EQ(crc16_ccitt(check_data, sizeof(check_data)), 0x29B1);
+}
+
+TEST(Crc, crc32_of_nothing_is_zero) {
+    EXPECT_EQ(crc32_bytewise(check_data, 0), 0);
+    EXPECT_EQ(crc32_slice_by_4(check_data, 0), 0);
+    EXPECT_EQ(crc32_slice_by_8(check_data, 0), 0);
+}
+
+TEST(Crc, crc16_of_nothing_is_the_initial_value) {
+    EXPECT_EQ(crc16_ccitt(check_data, 0), 0xFFFF);
+}
+
+TEST(Crc, crc32_matches_the_frame_validator_vectors) {
+    // The same frames and checksums as frame_validator_tests.cpp
+    uint8_t one_byte[] = {0x44};
+    uint8_t five_bytes[] = {1, 2, 3, 4, 5};
+    EXPECT_EQ(crc32_slice_by_4(one_byte, sizeof(one_byte)), 0xA3B36A04);
+    EXPECT_EQ(crc32_slice_by_4(five_bytes, sizeof(five_bytes)), 0x470B99F4);
+    EXPECT_EQ(crc32_slice_by_8(one_byte, sizeof(one_byte)), 0xA3B36A04);
+    EXPECT_EQ(crc32_slice_by_8(five_bytes, sizeof(five_bytes)), 0x470B99F4);
+}
+
+TEST(Crc, sliced_crc32_matches_bytewise_for_all_lengths_and_alignments) {
+    std::vector<uint8_t> data = pseudo_random_data(300);
+    for (uint16_t offset = 0; offset < 8; offset++) {
+        for (uint16_t size = 0; size + offset <= data.size(); size++) {
+            const uint8_t* p = data.data() + offset;
+            uint32_t expected = crc32_bytewise(p, size);
+            ASSERT_EQ(crc32_slice_by_4(p, size), expected) << "offset " << offset << " size " << size;
+            ASSERT_EQ(crc32_slice_by_8(p, size), expected) << "offset " << offset << " size " << size;
+        }
+    }
+}
+
+TEST(Crc, crc16_detects_a_single_bit_error) {
+    std::vector<uint8_t> data = pseudo_random_data(64);
+    uint16_t crc = crc16_ccitt(data.data(), data.size());
+    for (size_t i = 0; i < data.size() * 8; i++) {
+        data[i / 8] ^= 1 << (i % 8);
+        EXPECT_NE(crc16_ccitt(data.data(), data.size()), crc);
+        data[i / 8] ^= 1 << (i % 8);
+    }
+}
+
+template<typename F>
+static double megabytes_per_second(F crc, const std::vector<uint8_t>& data, uint16_t frame_size) {
+    const int rounds = 64;
+    volatile uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i + frame_size <= data.size(); i += frame_size) {
+            sink = sink + crc(data.data() + i, frame_size);
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double bytes = (double)rounds * (data.size() / frame_size * frame_size);
+    return bytes / elapsed.count() / 1e6;
+}
+
+// Not a pass/fail check, host numbers only give the relative cost of the
+// variants. The frame sizes are a matrix update and the largest frame.
+TEST(Crc, benchmark_throughput) {
+    std::vector<uint8_t> data = pseudo_random_data(64 * 1024);
+    for (uint16_t frame_size : {16, 256}) {
+        printf("[ CRC      ] %3u byte frames: bytewise %7.1f MB/s, slice-by-4 %7.1f MB/s, "
+            "slice-by-8 %7.1f MB/s, crc16 %7.1f MB/s\n",
+            frame_size,
+            megabytes_per_second(crc32_bytewise, data, frame_size),
+            megabytes_per_second(crc32_slice_by_4, data, frame_size),
+            megabytes_per_second(crc32_slice_by_8, data, frame_size),
+            megabytes_per_second(crc16_ccitt, data, frame_size));
+    }
+}
@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include <array>
+extern "C" {
+#include "serial_link/protocol/key_events.h"
+}
+
+class KeyEvents : public testing::Test {
+public:
+    KeyEvents() {
+        key_events_sender_init(&sender);
+        key_events_receiver_init(&receiver);
+        matrix.fill(0);
+    }
+
+    // One update of both sides, returns true if the receiver's rows changed
+    bool run() {
+        bool changed = false;
+        key_events_queue(&sender, matrix.data());
+        reliable_window_t window;
+        if (reliable_sender_poll(&sender.sender, now, &window)) {
+            reliable_ack_t ack;
+            changed = key_events_receive(&receiver, &window, &ack);
+            reliable_sender_ack(&sender.sender, &ack);
+        }
+        now++;
+        return changed;
+    }
+
+    void run_for(int updates) {
+        for (int i = 0; i < updates; i++) {
+            run();
+        }
+    }
+
+    void expect_receiver_has_matrix() {
+        for (int i = 0; i < MATRIX_ROWS; i++) {
+            EXPECT_EQ(receiver.rows[i], matrix[i]) << "row " << i;
+        }
+    }
+
+    key_events_sender_t sender;
+    key_events_receiver_t receiver;
+    std::array<matrix_row_t, MATRIX_ROWS> matrix;
+    uint16_t now = 0;
+};
+
+TEST_F(KeyEvents, presses_and_releases_reach_the_receiver) {
+    run_for(2);
+    matrix[3] = 0x5;
+    EXPECT_TRUE(run());
+    expect_receiver_has_matrix();
+    matrix[3] = 0x4;
+    matrix[MATRIX_ROWS - 1] = 0x10;
+    EXPECT_TRUE(run());
+    expect_receiver_has_matrix();
+    EXPECT_FALSE(run());
+}
+
+TEST_F(KeyEvents, edges_that_dont_fit_wait_for_room) {
+    run_for(2);
+    for (int i = 0; i < MATRIX_ROWS; i++) {
+        matrix[i] = 0x1F;
+    }
+    // The window is acknowledged as it goes, so everything gets through
+    run_for(MATRIX_ROWS * MATRIX_COLS / SERIAL_LINK_RELIABLE_WINDOW + 2);
+    expect_receiver_has_matrix();
+}
+
+TEST_F(KeyEvents, a_sender_restart_releases_the_keys_it_held) {
+    run_for(2);
+    matrix[1] = 0x2;
+    run();
+    EXPECT_EQ(receiver.rows[1], 0x2);
+
+    // The key is released while the sender is down
+    key_events_sender_init(&sender);
+    matrix[1] = 0;
+    EXPECT_TRUE(run());
+    expect_receiver_has_matrix();
+}
+
+TEST_F(KeyEvents, a_key_held_across_a_sender_restart_is_reported_again) {
+    run_for(2);
+    matrix[1] = 0x2;
+    matrix[2] = 0x1;
+    run();
+    key_events_sender_init(&sender);
+    matrix[2] = 0;
+    run_for(3);
+    expect_receiver_has_matrix();
+}
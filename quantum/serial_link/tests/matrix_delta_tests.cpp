@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+#include <array>
+extern "C" {
+#include "serial_link/protocol/matrix_delta.h"
+}
+
+class MatrixDelta : public testing::Test {
+public:
+    MatrixDelta() {
+        matrix_delta_init(&sender);
+        matrix_delta_init(&receiver);
+        rows.fill(0);
+    }
+
+    void send_snapshot() {
+        matrix_snapshot_t snapshot;
+        matrix_delta_take_snapshot(&sender, rows.data(), &snapshot);
+        matrix_delta_apply_snapshot(&receiver, &snapshot);
+    }
+
+    bool send_delta() {
+        matrix_delta_t delta;
+        if (!matrix_delta_diff(&sender, rows.data(), &delta)) {
+            return false;
+        }
+        return matrix_delta_apply(&receiver, &delta);
+    }
+
+    void expect_receiver_has_rows() {
+        for (int i = 0; i < MATRIX_ROWS; i++) {
+            EXPECT_EQ(receiver.rows[i], rows[i]) << "row " << i;
+        }
+    }
+
+    matrix_delta_state_t sender;
+    matrix_delta_state_t receiver;
+    std::array<matrix_row_t, MATRIX_ROWS> rows;
+};
+
+TEST_F(MatrixDelta, no_delta_before_the_first_snapshot) {
+    matrix_delta_t delta;
+    EXPECT_FALSE(matrix_delta_diff(&sender, rows.data(), &delta));
+}
+
+TEST_F(MatrixDelta, a_snapshot_transfers_all_rows) {
+    rows[0] = 1;
+    rows[7] = 0x12;
+    rows[MATRIX_ROWS - 1] = 0x10;
+    send_snapshot();
+    expect_receiver_has_rows();
+}
+
+TEST_F(MatrixDelta, an_unchanged_matrix_gives_an_empty_delta) {
+    rows[3] = 5;
+    send_snapshot();
+    matrix_delta_t delta;
+    EXPECT_TRUE(matrix_delta_diff(&sender, rows.data(), &delta));
+    EXPECT_EQ(delta.num_keys, 0);
+    EXPECT_EQ(matrix_delta_size(&delta), 2);
+}
+
+TEST_F(MatrixDelta, a_delta_lists_the_toggled_keys) {
+    rows[1] = 1;
+    send_snapshot();
+    rows[1] = 0;
+    rows[2] = 0x11;
+    matrix_delta_t delta;
+    EXPECT_TRUE(matrix_delta_diff(&sender, rows.data(), &delta));
+    ASSERT_EQ(delta.num_keys, 3);
+    EXPECT_EQ(delta.keys[0], 1 * MATRIX_COLS + 0);
+    EXPECT_EQ(delta.keys[1], 2 * MATRIX_COLS + 0);
+    EXPECT_EQ(delta.keys[2], 2 * MATRIX_COLS + 4);
+    EXPECT_EQ(matrix_delta_size(&delta), 5);
+    EXPECT_TRUE(matrix_delta_apply(&receiver, &delta));
+    expect_receiver_has_rows();
+}
+
+TEST_F(MatrixDelta, a_newer_delta_replaces_an_older_one) {
+    send_snapshot();
+    rows[4] = 2;
+    matrix_delta_t lost;
+    EXPECT_TRUE(matrix_delta_diff(&sender, rows.data(), &lost));
+    rows[5] = 8;
+    EXPECT_TRUE(send_delta());
+    expect_receiver_has_rows();
+    rows[4] = 0;
+    EXPECT_TRUE(send_delta());
+    expect_receiver_has_rows();
+}
+
+TEST_F(MatrixDelta, too_many_keys_need_a_snapshot) {
+    send_snapshot();
+    for (int i = 0; i <= SERIAL_LINK_DELTA_KEYS; i++) {
+        rows[i] = 1;
+    }
+    EXPECT_FALSE(send_delta());
+    send_snapshot();
+    expect_receiver_has_rows();
+    EXPECT_TRUE(send_delta());
+}
+
+TEST_F(MatrixDelta, a_delta_for_a_lost_snapshot_is_ignored_until_the_next_one) {
+    send_snapshot();
+    rows[0] = 1;
+    matrix_snapshot_t lost;
+    matrix_delta_take_snapshot(&sender, rows.data(), &lost);
+    rows[1] = 1;
+    EXPECT_FALSE(send_delta());
+    EXPECT_EQ(receiver.rows[0], 0);
+    EXPECT_EQ(receiver.rows[1], 0);
+    send_snapshot();
+    expect_receiver_has_rows();
+}
+
+TEST_F(MatrixDelta, a_delta_with_invalid_keys_is_ignored) {
+    send_snapshot();
+    matrix_delta_t delta = {};
+    delta.snapshot = sender.snapshot.sequence;
+    delta.num_keys = 1;
+    delta.keys[0] = MATRIX_ROWS * MATRIX_COLS;
+    EXPECT_FALSE(matrix_delta_apply(&receiver, &delta));
+    delta.keys[0] = 0;
+    delta.num_keys = SERIAL_LINK_DELTA_KEYS + 1;
+    EXPECT_FALSE(matrix_delta_apply(&receiver, &delta));
+    expect_receiver_has_rows();
+}
+
+TEST_F(MatrixDelta, snapshot_sequence_numbers_wrap) {
+    for (int i = 0; i < 300; i++) {
+        rows[0] = i & 1;
+        send_snapshot();
+    }
+    rows[1] = 1;
+    EXPECT_TRUE(send_delta());
+    expect_receiver_has_rows();
+}
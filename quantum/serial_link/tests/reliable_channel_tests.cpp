@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+#include <vector>
+extern "C" {
+#include "serial_link/protocol/reliable_channel.h"
+}
+
+class ReliableChannel : public testing::Test {
+public:
+    ReliableChannel() {
+        reliable_sender_init(&sender);
+        reliable_receiver_init(&receiver);
+    }
+
+    // Runs the link for one ms, the windows and acks that are dropped are
+    // the ones the lose functions return true for
+    template<typename LoseWindow, typename LoseAck>
+    void run(LoseWindow lose_window, LoseAck lose_ack) {
+        reliable_window_t window;
+        if (reliable_sender_poll(&sender, now, &window)) {
+            windows_sent++;
+            if (!lose_window()) {
+                reliable_event_t events[SERIAL_LINK_RELIABLE_WINDOW];
+                reliable_ack_t ack;
+                uint8_t num = reliable_receive(&receiver, &window, events, &ack);
+                received.insert(received.end(), events, events + num);
+                if (!lose_ack()) {
+                    reliable_sender_ack(&sender, &ack);
+                }
+            }
+        }
+        now++;
+    }
+
+    void run() {
+        run([]() { return false; }, []() { return false; });
+    }
+
+    reliable_sender_t sender;
+    reliable_receiver_t receiver;
+    std::vector<reliable_event_t> received;
+    uint16_t now = 0;
+    int windows_sent = 0;
+};
+
+TEST_F(ReliableChannel, only_the_sync_is_sent_without_events) {
+    for (int i = 0; i < 100; i++) {
+        run();
+    }
+    EXPECT_EQ(windows_sent, 1);
+    EXPECT_TRUE(sender.synced);
+}
+
+TEST_F(ReliableChannel, the_sync_is_retried_until_acked) {
+    for (int i = 0; i < 3 * SERIAL_LINK_RETRANSMIT_INTERVAL; i++) {
+        run([]() { return false; }, []() { return true; });
+    }
+    EXPECT_EQ(windows_sent, 3);
+    EXPECT_FALSE(sender.synced);
+}
+
+TEST_F(ReliableChannel, the_first_window_only_syncs) {
+    reliable_sender_push(&sender, 5);
+    reliable_window_t window;
+    EXPECT_TRUE(reliable_sender_poll(&sender, now, &window));
+    EXPECT_EQ(window.flags, RELIABLE_WINDOW_SYNC);
+    EXPECT_EQ(window.num_events, 0);
+    EXPECT_EQ(reliable_window_size(&window), 4);
+}
+
+TEST_F(ReliableChannel, events_are_delivered_once_and_in_order) {
+    reliable_sender_push(&sender, 1);
+    reliable_sender_push(&sender, 2);
+    run();
+    run();
+    reliable_sender_push(&sender, 3);
+    for (int i = 0; i < 100; i++) {
+        run();
+    }
+    EXPECT_EQ(received, std::vector<reliable_event_t>({1, 2, 3}));
+    EXPECT_EQ(windows_sent, 3);
+}
+
+TEST_F(ReliableChannel, a_full_window_refuses_events_until_acked) {
+    for (int i = 0; i < SERIAL_LINK_RELIABLE_WINDOW; i++) {
+        EXPECT_TRUE(reliable_sender_push(&sender, i));
+    }
+    EXPECT_FALSE(reliable_sender_push(&sender, 100));
+    run();
+    run();
+    EXPECT_TRUE(reliable_sender_push(&sender, 100));
+    EXPECT_EQ(received.size(), SERIAL_LINK_RELIABLE_WINDOW);
+}
+
+TEST_F(ReliableChannel, a_lost_window_is_resent_after_the_retransmit_interval) {
+    reliable_sender_push(&sender, 7);
+    run();
+    bool lose = true;
+    run([&lose]() { bool l = lose; lose = false; return l; }, []() { return false; });
+    EXPECT_TRUE(received.empty());
+    for (int i = 1; i < SERIAL_LINK_RETRANSMIT_INTERVAL; i++) {
+        run();
+    }
+    EXPECT_TRUE(received.empty());
+    run();
+    EXPECT_EQ(received, std::vector<reliable_event_t>({7}));
+}
+
+TEST_F(ReliableChannel, a_lost_ack_does_not_duplicate_events) {
+    reliable_sender_push(&sender, 7);
+    run();
+    bool lose = true;
+    run([]() { return false; }, [&lose]() { bool l = lose; lose = false; return l; });
+    for (int i = 0; i < 20; i++) {
+        run();
+    }
+    EXPECT_EQ(received, std::vector<reliable_event_t>({7}));
+    EXPECT_EQ(windows_sent, 3);
+}
+
+TEST_F(ReliableChannel, no_event_is_lost_or_duplicated_on_a_lossy_link) {
+    uint32_t state = 1;
+    auto lose = [&state]() {
+        state = state * 1103515245 + 12345;
+        return (state >> 16) % 3 == 0;
+    };
+    std::vector<reliable_event_t> sent;
+    reliable_event_t next_event = 0;
+    for (int i = 0; i < 5000; i++) {
+        if (i % 2 == 0 && reliable_sender_push(&sender, next_event)) {
+            sent.push_back(next_event++);
+        }
+        run(lose, lose);
+    }
+    for (int i = 0; i < 1000; i++) {
+        run(lose, lose);
+    }
+    EXPECT_GT(sent.size(), 300u);
+    EXPECT_EQ(received, sent);
+}
+
+TEST_F(ReliableChannel, the_sender_can_restart) {
+    reliable_sender_push(&sender, 1);
+    run();
+    run();
+    reliable_sender_init(&sender);
+    reliable_sender_push(&sender, 2);
+    for (int i = 0; i < 10; i++) {
+        run();
+    }
+    EXPECT_EQ(received, std::vector<reliable_event_t>({1, 2}));
+}
+
+TEST_F(ReliableChannel, the_receiver_can_restart) {
+    reliable_sender_push(&sender, 1);
+    run();
+    run();
+    reliable_receiver_init(&receiver);
+    reliable_sender_push(&sender, 2);
+    for (int i = 0; i < 10; i++) {
+        run();
+    }
+    EXPECT_EQ(received, std::vector<reliable_event_t>({1, 2}));
+}
+
+TEST_F(ReliableChannel, sequence_numbers_wrap) {
+    for (int i = 0; i < 1000; i++) {
+        reliable_sender_push(&sender, i);
+        run();
+    }
+    for (int i = 0; i < 10; i++) {
+        run();
+    }
+    ASSERT_EQ(received.size(), 1000u);
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(received[i], i);
+    }
+}
@@ -2,20 +2,42 @@ serial_link_byte_stuffer_SRC :=\
 	$(SERIAL_PATH)/tests/byte_stuffer_tests.cpp \
 	$(SERIAL_PATH)/protocol/byte_stuffer.c
 
+serial_link_crc_SRC := \
+	$(SERIAL_PATH)/tests/crc_tests.cpp \
+	$(SERIAL_PATH)/protocol/crc.c
+
 serial_link_frame_validator_SRC := \
 	$(SERIAL_PATH)/tests/frame_validator_tests.cpp \
-	$(SERIAL_PATH)/protocol/frame_validator.c 
+	$(SERIAL_PATH)/protocol/frame_validator.c \
+	$(SERIAL_PATH)/protocol/crc.c
 
 serial_link_frame_router_SRC := \
 	$(SERIAL_PATH)/tests/frame_router_tests.cpp \
 	$(SERIAL_PATH)/protocol/byte_stuffer.c \
 	$(SERIAL_PATH)/protocol/frame_validator.c \
+	$(SERIAL_PATH)/protocol/crc.c \
 	$(SERIAL_PATH)/protocol/frame_router.c
 
 serial_link_triple_buffered_object_SRC := \
 	$(SERIAL_PATH)/tests/triple_buffered_object_tests.cpp \
 	$(SERIAL_PATH)/protocol/triple_buffered_object.c 
 
+serial_link_matrix_delta_SRC := \
+	$(SERIAL_PATH)/tests/matrix_delta_tests.cpp \
+	$(SERIAL_PATH)/protocol/matrix_delta.c
+# The split ErgoDox matrix
+serial_link_matrix_delta_DEFS := -DMATRIX_ROWS=18 -DMATRIX_COLS=5
+
+serial_link_reliable_channel_SRC := \
+	$(SERIAL_PATH)/tests/reliable_channel_tests.cpp \
+	$(SERIAL_PATH)/protocol/reliable_channel.c
+
+serial_link_key_events_SRC := \
+	$(SERIAL_PATH)/tests/key_events_tests.cpp \
+	$(SERIAL_PATH)/protocol/key_events.c \
+	$(SERIAL_PATH)/protocol/reliable_channel.c
+serial_link_key_events_DEFS := -DMATRIX_ROWS=18 -DMATRIX_COLS=5
+
 serial_link_transport_SRC := \
 	$(SERIAL_PATH)/tests/transport_tests.cpp \
 	$(SERIAL_PATH)/protocol/transport.c \
@@ -1,6 +1,10 @@
 TEST_LIST +=\
 	serial_link_byte_stuffer\
+	serial_link_crc\
 	serial_link_frame_validator\
 	serial_link_frame_router\
 	serial_link_triple_buffered_object\
+	serial_link_matrix_delta\
+	serial_link_reliable_channel\
+	serial_link_key_events\
 	serial_link_transport
\ No newline at end of file
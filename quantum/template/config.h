@@ -60,6 +60,36 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /* define if matrix has ghost (lacks anti-ghosting diodes) */
 //#define MATRIX_HAS_GHOST
 
+/* number of matrix changes processed per scan, raise to handle chords in one pass */
+//#define QMK_KEYS_PER_SCAN 4
+
+/* cache the resolved layer of each key, costs one byte of RAM per key */
+//#define LAYER_RESOLUTION_CACHE
+
+/* stop scanning and sleep while nothing is pressed or waiting on a timeout */
+//#define MATRIX_IDLE_SLEEP
+
+/* play macros and send_string() a report at a time instead of blocking, paced
+ * by the endpoint with KEYBOARD_REPORT_QUEUE */
+//#define NONBLOCKING_MACROS
+
+/* queue keyboard reports and send them from the USB IN-complete callback (ChibiOS, LUFA) */
+//#define KEYBOARD_REPORT_QUEUE
+
+/* ChibiOS: poll the keyboard endpoints every frame and stage reports behind the one in flight */
+//#define USB_POLLING_INTERVAL_MS 1
+
+/* ChibiOS: start each scan on the USB start-of-frame */
+//#define USB_SOF_SYNC
+
+/* ChibiOS: scan the matrix in its own higher priority thread */
+//#define SCAN_THREAD
+
+/* tap/hold: per key tapping terms and deciding a held tap key early, see action_tapping.h */
+//#define TAPPING_TERM_PER_KEY
+//#define PERMISSIVE_HOLD
+//#define HOLD_ON_OTHER_KEY_PRESS
+
 /* number of backlight levels */
 
 /* Mechanical locking support. Use KC_LCAP, KC_LNUM or KC_LSCR instead in keymap */
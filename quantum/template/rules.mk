@@ -65,3 +65,6 @@ MIDI_ENABLE ?= no            # MIDI controls
 UNICODE_ENABLE ?= no         # Unicode
 BLUETOOTH_ENABLE ?= no       # Enable Bluetooth with the Adafruit EZ-Key HID
 AUDIO_ENABLE ?= no           # Audio output on port C6
+DEBOUNCE_TYPE ?= sym_g       # Debounce algorithm: sym_g, sym_pk, eager_defer_pk or eager_pr
+ACTION_TABLE_ENABLE ?= no    # Decode keymap actions at build time, costs as much flash as the keymap
+LATENCY_BENCH_ENABLE ?= no   # Time the scan-to-report path, dump with Magic+B (needs CONSOLE and COMMAND)
@@ -0,0 +1,64 @@
+/* Build time generator for ACTION_TABLE_ENABLE, see quantum/action_table.h
+ *
+ * Reads the raw contents of keymaps[] as copied out of the compiled keymap
+ * object and prints a C source with the matching keymap_actions[] table.
+ * Built and run on the host by quantum/action_table.mk.
+ *
+ *   gen_action_table keymaps.bin > keymap_actions.c
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "keycode_config.h"
+#include "action_table.h"
+
+static uint16_t keycode_to_table_action(uint16_t keycode)
+{
+    action_t action;
+
+    // these depend on keymap_config, resolve them at runtime
+    if (IS_REMAPPABLE_KEYCODE(keycode)) {
+        return ACTION_DYNAMIC;
+    }
+    if (!keycode_to_static_action(keycode, &action)) {
+        return ACTION_DYNAMIC;
+    }
+    return action.code;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s keymaps.bin\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    printf("/* Generated from %s by gen_action_table, do not edit. */\n", argv[1]);
+    printf("#include \"progmem.h\"\n");
+    printf("#include \"action_table.h\"\n\n");
+    printf("const uint16_t keymap_actions[] PROGMEM = {");
+
+    // keymaps[] is little endian on every supported target
+    unsigned count = 0;
+    int lo, hi;
+    while ((lo = fgetc(in)) != EOF && (hi = fgetc(in)) != EOF) {
+        uint16_t keycode = (uint16_t)(lo | hi << 8);
+        printf("%s0x%04X,", (count % 8) ? " " : "\n    ", keycode_to_table_action(keycode));
+        count++;
+    }
+    fclose(in);
+
+    if (count == 0 || count > UINT16_MAX) {
+        fprintf(stderr, "%s: unexpected keymaps size\n", argv[1]);
+        return 1;
+    }
+
+    printf("\n};\n\n");
+    printf("const uint16_t keymap_actions_count = %u;\n", count);
+    return 0;
+}
@@ -0,0 +1,7 @@
+#ifndef TESTS_ACTION_TABLE_CONFIG_H_
+#define TESTS_ACTION_TABLE_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+#endif /* TESTS_ACTION_TABLE_CONFIG_H_ */
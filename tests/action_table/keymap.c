@@ -0,0 +1,24 @@
+#include "quantum.h"
+
+/* A bit of every kind of keycode, row 3 of layer 0 is the ones that depend
+ * on runtime state */
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A,        KC_Z,        KC_1,        KC_ENT,      KC_F24,      KC_RSFT,     KC_EXSEL,    KC_NO,       KC_TRNS,     KC_NUHS},
+        {LCTL(KC_B),  LSFT(KC_1),  HYPR(KC_C),  MO(1),       TG(2),       TO(1),       DF(2),       OSL(1),      OSM(MOD_LSFT), LT(1, KC_SPC)},
+        {CTL_T(KC_D), ALT_T(KC_E), M(3),        KC_MS_U,     KC_WH_D,     KC_MS_ACCEL2, KC_PWR,     KC_WAKE,     KC_MUTE,     KC_MRWD},
+        {KC_FN0,      KC_FN31,     F(1),        KC_LALT,     KC_LGUI,     KC_CAPS,     KC_ESC,      KC_GRV,      KC_BSLS,     KC_BSPC},
+    },
+    [1] = {
+        {KC_TRNS,     KC_2,        KC_NO,       KC_LCTL,     KC_RALT,     KC_RGUI,     KC_LCAP,     RESET,       DEBUG,       MAGIC_TOGGLE_NKRO},
+        {KC_TRNS,     KC_TRNS,     KC_TRNS,     KC_TRNS,     KC_TRNS,     KC_TRNS,     KC_TRNS,     KC_TRNS,     KC_TRNS,     KC_TRNS},
+        {KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO},
+        {KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO},
+    },
+    [2] = {
+        {KC_B,        KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO},
+        {KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO},
+        {KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO},
+        {KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO,       KC_NO},
+    },
+};
@@ -0,0 +1,3 @@
+# The build time action table of quantum/action_table.mk, built from this
+# keymap and compared with the runtime decode
+ACTION_TABLE_GENERATE = yes
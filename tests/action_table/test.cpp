@@ -0,0 +1,74 @@
+#include "test_fixture.h"
+extern "C" {
+    #include "keymap.h"
+    #include "keycode_config.h"
+    #include "action_table.h"
+
+    /* generated by gen_action_table, the build doesn't use it */
+    extern const uint16_t keymap_actions[];
+    extern const uint16_t keymap_actions_count;
+}
+
+static const uint8_t num_layers = 3;
+
+class ActionTable : public TestFixture {
+protected:
+    static uint16_t table_action(uint8_t layer, keypos_t key) {
+        return keymap_actions[(layer * MATRIX_ROWS + key.row) * MATRIX_COLS + key.col];
+    }
+
+    template<typename F>
+    static void for_each_key(F f) {
+        for (uint8_t layer = 0; layer < num_layers; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    f(layer, (keypos_t){ .col = col, .row = row });
+                }
+            }
+        }
+    }
+};
+
+TEST_F(ActionTable, HasAnEntryPerKeymapEntry) {
+    EXPECT_EQ(keymap_actions_count, num_layers * MATRIX_ROWS * MATRIX_COLS);
+}
+
+TEST_F(ActionTable, StaticEntriesMatchTheRuntimeDecode) {
+    int static_entries = 0;
+    for_each_key([&](uint8_t layer, keypos_t key) {
+        uint16_t action = table_action(layer, key);
+        if (action != ACTION_DYNAMIC) {
+            EXPECT_EQ(action, action_for_key(layer, key).code)
+                << "layer " << (int)layer << " row " << (int)key.row << " col " << (int)key.col;
+            static_entries++;
+        }
+    });
+    EXPECT_GT(static_entries, 100);
+}
+
+TEST_F(ActionTable, OnlyKeycodesNeedingRuntimeStateAreDynamic) {
+    for_each_key([](uint8_t layer, keypos_t key) {
+        uint16_t keycode = keymap_key_to_keycode(layer, key);
+        bool runtime = IS_REMAPPABLE_KEYCODE(keycode) ||
+            (keycode >= KC_FN0 && keycode <= KC_FN31) ||
+            (keycode >= QK_FUNCTION && keycode <= QK_FUNCTION_MAX) ||
+            (keycode >= 0x7000 && keycode <= 0x70FF);
+        EXPECT_EQ(table_action(layer, key) == ACTION_DYNAMIC, runtime)
+            << "layer " << (int)layer << " row " << (int)key.row << " col " << (int)key.col
+            << " keycode " << std::hex << keycode;
+    });
+}
+
+TEST_F(ActionTable, RemappableAndFnKeysFallBackToTheRuntimeDecode) {
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        EXPECT_EQ(table_action(0, (keypos_t){ .col = col, .row = 3 }), ACTION_DYNAMIC) << "col " << (int)col;
+    }
+}
+
+TEST_F(ActionTable, DynamicEntriesFollowTheKeymapConfig) {
+    keypos_t lalt = { .col = 3, .row = 3 };
+    keymap_config.swap_lalt_lgui = true;
+    EXPECT_EQ(action_for_key(0, lalt).code, ACTION_KEY(KC_LGUI));
+    keymap_config.swap_lalt_lgui = false;
+    EXPECT_EQ(action_for_key(0, lalt).code, ACTION_KEY(KC_LALT));
+}
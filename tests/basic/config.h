@@ -0,0 +1,10 @@
+#ifndef TESTS_BASIC_CONFIG_H_
+#define TESTS_BASIC_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+#define QMK_KEYS_PER_SCAN 4
+#define MATRIX_IDLE_SLEEP
+
+#endif /* TESTS_BASIC_CONFIG_H_ */
@@ -0,0 +1,2 @@
+# Core action pipeline only, plus the latency counters so they are exercised
+LATENCY_BENCH_ENABLE = yes
@@ -0,0 +1,206 @@
+#include "test_fixture.h"
+#include "test_driver.h"
+#include "test_matrix.h"
+#include "keyboard_report_util.h"
+extern "C" {
+    #include "keycode.h"
+    #include "bench.h"
+    #include "keyboard.h"
+    #include "action.h"
+    #include "action_util.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class Basic : public TestFixture {};
+
+// The simulated matrix doesn't debounce, the tests say when a key is settling
+static bool debouncing = false;
+
+extern "C" bool debounce_active(void) {
+    return debouncing;
+}
+
+TEST_F(Basic, SendKeyboardIsNotCalledWhenNoKeyIsPressed) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(10);
+}
+
+TEST_F(Basic, KeyPressAndReleaseAreEachReportedOnTheScanTheyHappen) {
+    TestDriver driver;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Basic, ModifierIsSentAsModifierBit) {
+    TestDriver driver;
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(3, 0);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    run_one_scan_loop();
+}
+
+TEST_F(Basic, ChordIsDispatchedInOneScan) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    run_one_scan_loop();
+
+    release_key(0, 0);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Basic, MomentaryLayerAppliesToKeysPressedWhileHeld) {
+    TestDriver driver;
+    /* The layer change clears an already empty report, nothing is sent */
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Every layer change clears the keyboard report */
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+}
+
+TEST_F(Basic, UnchangedReportsAreNotSent) {
+    TestDriver driver;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    register_code(KC_A);
+    send_keyboard_report();
+    unregister_code(KC_B);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Basic, ReportsAreComparedWithWhatTheCurrentDriverWasSent) {
+    report_keyboard_t empty = {};
+    report_keyboard_t a = {};
+    a.keys[0] = KC_A;
+    /* without a driver nothing is sent, so nothing is remembered either */
+    host_keyboard_send(&a);
+    {
+        TestDriver driver;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        host_keyboard_send(&a);
+    }
+    /* a new driver starts from an empty report */
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    host_keyboard_send(&empty);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    host_keyboard_send(&a);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    host_keyboard_send(&empty);
+}
+
+TEST_F(Basic, LatencyBenchCountsEveryStage) {
+    TestDriver driver;
+    bench_clear();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(9);
+
+    EXPECT_EQ(bench_get_stats(BENCH_MATRIX_SCAN)->count, 10);
+    EXPECT_EQ(bench_get_stats(BENCH_ACTION_EXEC)->count, 1);
+    EXPECT_EQ(bench_get_stats(BENCH_PROCESS_RECORD_QUANTUM)->count, 1);
+    EXPECT_EQ(bench_get_stats(BENCH_HOST_KEYBOARD_SEND)->count, 1);
+    EXPECT_EQ(bench_get_stats(BENCH_SCAN_TO_REPORT)->count, 1);
+}
+
+TEST_F(Basic, IdleKeyboardStopsScanningUntilAKeyIsPressed) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    EXPECT_TRUE(keyboard_is_idle());
+    bench_clear();
+    idle_for(10);
+    EXPECT_EQ(bench_get_stats(BENCH_MATRIX_SCAN)->count, 0);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    EXPECT_FALSE(keyboard_is_idle());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    /* the first scan without changes goes back to sleep */
+    EXPECT_FALSE(keyboard_is_idle());
+    run_one_scan_loop();
+    EXPECT_TRUE(keyboard_is_idle());
+}
+
+TEST_F(Basic, KeyboardDoesNotSleepWhileAKeyIsDebouncing) {
+    TestDriver driver;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* another key is bouncing, so the matrix is empty but not settled */
+    release_key(0, 0);
+    debouncing = true;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    run_one_scan_loop();
+    run_one_scan_loop();
+    EXPECT_FALSE(keyboard_is_idle());
+
+    debouncing = false;
+    run_one_scan_loop();
+    EXPECT_TRUE(keyboard_is_idle());
+}
@@ -0,0 +1,10 @@
+#ifndef TESTS_LAYER_CACHE_CONFIG_H_
+#define TESTS_LAYER_CACHE_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+#define PREVENT_STUCK_MODIFIERS
+#define LAYER_RESOLUTION_CACHE
+
+#endif /* TESTS_LAYER_CACHE_CONFIG_H_ */
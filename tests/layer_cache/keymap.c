@@ -0,0 +1,36 @@
+#include "quantum.h"
+
+/* Layers 5 and 10 set alternate bits of the cached layer number. Modifiers
+ * survive the clear of a layer change, so a release resolved on the wrong
+ * layer leaves one stuck in the report. */
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL},
+        {KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL},
+        {KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL},
+        {KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, KC_LCTL, MO(5),   MO(10)},
+    },
+    [5] = {
+        {KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT},
+        {KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT},
+        {KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT},
+        {KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_LSFT, KC_TRNS, KC_TRNS},
+    },
+    [10] = {
+        {KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT},
+        {KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT},
+        {KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT},
+        {KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_LALT, KC_TRNS, KC_TRNS},
+    },
+};
+
+/* Edits made to layer 5 at runtime, KC_NO where the key is unchanged */
+uint16_t layer5_edits[MATRIX_ROWS][MATRIX_COLS];
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key)
+{
+    if (layer == 5 && layer5_edits[key.row][key.col] != KC_NO) {
+        return layer5_edits[key.row][key.col];
+    }
+    return pgm_read_word(&keymaps[layer][key.row][key.col]);
+}
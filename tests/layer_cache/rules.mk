@@ -0,0 +1,3 @@
+# Layers of held keys cached at press in the default byte per key layout,
+# and the resolved layer cache. layer_cache_nibble and layer_cache_sliced run
+# the same cases on the other layouts.
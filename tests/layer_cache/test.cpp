@@ -0,0 +1,141 @@
+#include "test_fixture.h"
+#include "test_driver.h"
+#include "test_matrix.h"
+#include "keyboard_report_util.h"
+extern "C" {
+    #include "keycode.h"
+    #include "action_layer.h"
+    #include "action_util.h"
+    extern uint16_t layer5_edits[MATRIX_ROWS][MATRIX_COLS];
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Mock;
+
+/* Every key is LCTL on layer 0, LSFT on layer 5 and LALT on layer 10, with
+ * MO(5) and MO(10) on the last two keys of row 3. */
+class LayerCache : public TestFixture {
+public:
+    ~LayerCache() {
+        memset(layer5_edits, 0, sizeof(layer5_edits));
+        layer_cache_invalidate();
+    }
+
+    void press(uint8_t key_number) {
+        press_key(key_number % MATRIX_COLS, key_number / MATRIX_COLS);
+        run_one_scan_loop();
+    }
+
+    void release(uint8_t key_number) {
+        release_key(key_number % MATRIX_COLS, key_number / MATRIX_COLS);
+        run_one_scan_loop();
+    }
+
+    static const uint8_t mo_5 = MATRIX_ROWS * MATRIX_COLS - 2;
+    static const uint8_t mo_10 = MATRIX_ROWS * MATRIX_COLS - 1;
+};
+
+TEST_F(LayerCache, ModifierPressedOnALayerIsReleasedAfterIt) {
+    TestDriver driver;
+    press(mo_5);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    press(0);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    /* The layer change keeps the modifier, so there's nothing to report */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    release(mo_5);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release(0);
+}
+
+TEST_F(LayerCache, ModifierPressedBeforeALayerIsReleasedOnItsOwn) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    press(11);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    press(mo_10);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release(11);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    release(mo_10);
+}
+
+TEST_F(LayerCache, NeighbouringKeysKeepTheirOwnLayers) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    /* Three neighbours held on layers 0b0101, 0b1010 and 0 at every position,
+     * so each shares a byte, nibble pair or bit plane with another */
+    for (uint8_t key = 0; key + 2 < mo_5; key++) {
+        press(mo_5);
+        press(key);
+        release(mo_5);
+        press(mo_10);
+        press(key + 1);
+        release(mo_10);
+        press(key + 2);
+        ASSERT_EQ(get_mods(), MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT) | MOD_BIT(KC_LALT)) << "key " << (int)key;
+
+        release(key + 1);
+        EXPECT_EQ(get_mods(), MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT)) << "key " << (int)key + 1;
+        release(key);
+        EXPECT_EQ(get_mods(), MOD_BIT(KC_LCTL)) << "key " << (int)key;
+        release(key + 2);
+        EXPECT_EQ(get_mods(), 0) << "key " << (int)key + 2;
+    }
+}
+
+TEST_F(LayerCache, ResolvedLayerFollowsTheLayerState) {
+    TestDriver driver;
+    press(mo_5);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    press(12);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    release(12);
+    release(mo_5);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    press(12);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release(12);
+}
+
+TEST_F(LayerCache, InvalidatedResolutionPicksUpKeymapEdits) {
+    TestDriver driver;
+    press(mo_5);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    press(13);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release(13);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    /* Same layer state, so only the invalidation drops layer 5 for the key */
+    layer5_edits[1][3] = KC_TRNS;
+    layer_cache_invalidate();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    press(13);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release(13);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    release(mo_5);
+}
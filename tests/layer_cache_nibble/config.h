@@ -0,0 +1,9 @@
+#ifndef TESTS_LAYER_CACHE_NIBBLE_CONFIG_H_
+#define TESTS_LAYER_CACHE_NIBBLE_CONFIG_H_
+
+#include "../layer_cache/config.h"
+
+#define SOURCE_LAYERS_CACHE_PACKED
+#define MAX_LAYER_BITS 4
+
+#endif /* TESTS_LAYER_CACHE_NIBBLE_CONFIG_H_ */
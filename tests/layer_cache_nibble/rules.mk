@@ -0,0 +1,2 @@
+# The layer_cache cases with a nibble per key
+TEST_SOURCE_PATH := tests/layer_cache
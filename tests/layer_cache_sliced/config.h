@@ -0,0 +1,8 @@
+#ifndef TESTS_LAYER_CACHE_SLICED_CONFIG_H_
+#define TESTS_LAYER_CACHE_SLICED_CONFIG_H_
+
+#include "../layer_cache/config.h"
+
+#define SOURCE_LAYERS_CACHE_SLICED
+
+#endif /* TESTS_LAYER_CACHE_SLICED_CONFIG_H_ */
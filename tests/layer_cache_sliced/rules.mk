@@ -0,0 +1,2 @@
+# The layer_cache cases with a bit plane per layer bit
+TEST_SOURCE_PATH := tests/layer_cache
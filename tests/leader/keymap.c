@@ -0,0 +1,27 @@
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A,   KC_B,    KC_C,    KC_LEAD, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,  KC_NO,   KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,  KC_NO,   KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,  KC_NO,   KC_NO,   KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+static void tap(uint8_t code) {
+    register_code(code);
+    unregister_code(code);
+}
+
+static void leader_w(void) { tap(KC_W); }
+static void leader_x(void) { tap(KC_X); }
+static void leader_y(void) { tap(KC_Y); }
+static void leader_z(void) { tap(KC_Z); }
+
+LEADER_TABLE(
+    LEADER_SEQ(leader_x, KC_A),
+    LEADER_SEQ(leader_y, KC_A, KC_B),
+    LEADER_SEQ(leader_z, KC_B, KC_C),
+    LEADER_SEQ(leader_w, KC_C, KC_C, KC_C, KC_C, KC_C, KC_C),
+);
@@ -0,0 +1 @@
+# Leader sequences from a LEADER_TABLE()
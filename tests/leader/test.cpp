@@ -0,0 +1,101 @@
+#include "test_fixture.h"
+#include "test_driver.h"
+#include "test_matrix.h"
+#include "keyboard_report_util.h"
+extern "C" {
+    #include "keycode.h"
+    #include "process_leader.h"
+}
+
+using testing::_;
+using testing::InSequence;
+using testing::Mock;
+
+/* The table: A -> X, A B -> Y, B C -> Z, C C C C C C -> W */
+class Leader : public TestFixture {
+protected:
+    void tap_key(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(Leader, SequenceFiresOnItsLastKey) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(3);
+    press_key(1, 0);
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 0);
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(LEADER_TIMEOUT);
+}
+
+TEST_F(Leader, PrefixOfALongerSequenceWaitsForTheTimeout) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(3);
+    tap_key(0);
+    idle_for(LEADER_TIMEOUT - 3);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Leader, LongerSequenceFiresWithoutTheTimeout) {
+    TestDriver driver;
+    InSequence s;
+    tap_key(3);
+    tap_key(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Y)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(Leader, SequencesCanBeLongerThanFiveKeys) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(3);
+    for (int i = 0; i < 5; i++) {
+        tap_key(2);
+    }
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_W)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    tap_key(2);
+}
+
+TEST_F(Leader, UnknownSequenceEndsTheLeader) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(3);
+    tap_key(2);
+    tap_key(0);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    // the next key types again
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    tap_key(0);
+}
@@ -0,0 +1,13 @@
+#ifndef TESTS_MACRO_CONFIG_H_
+#define TESTS_MACRO_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+#define NONBLOCKING_MACROS
+/* steps are paced by the endpoint taking each report */
+#define KEYBOARD_REPORT_QUEUE
+/* playback has to keep going while the matrix sleeps */
+#define MATRIX_IDLE_SLEEP
+
+#endif /* TESTS_MACRO_CONFIG_H_ */
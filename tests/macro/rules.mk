@@ -0,0 +1 @@
+# Macro and send_string playback from keyboard_task()
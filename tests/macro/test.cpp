@@ -0,0 +1,132 @@
+#include "test_fixture.h"
+#include "test_driver.h"
+#include "test_matrix.h"
+#include "keyboard_report_util.h"
+extern "C" {
+    #include "keycode.h"
+    #include "action.h"
+    #include "deadline.h"
+}
+
+using testing::_;
+using testing::InSequence;
+using testing::Mock;
+
+/* Macros and strings are played a report per step from keyboard_task(), each
+ * step once the endpoint has taken the report of the one before. */
+class Macro : public TestFixture {};
+
+TEST_F(Macro, MacroStepsWaitForTheEndpoint) {
+    TestDriver driver;
+    driver.hold_transfers(true);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(20);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    driver.complete_transfer();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    driver.complete_transfer();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    driver.complete_transfer();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    // W(50) is a step of its own after U(LSFT)
+    driver.complete_transfer();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(1 + 50 - 1);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    driver.complete_transfer();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_FALSE(action_macro_playing());
+    driver.complete_transfer();
+    driver.hold_transfers(false);
+}
+
+TEST_F(Macro, SendStringTypesACharacterPerReport) {
+    TestDriver driver;
+    InSequence s;
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_H)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_I)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(1 + 6);
+    EXPECT_FALSE(action_macro_playing());
+    release_key(1, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(Macro, KeysPressedDuringPlaybackFollowTheMacro) {
+    TestDriver driver;
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    press_key(2, 0);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_H)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_I)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    idle_for(10);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Macro, PlaybackContinuesWhileTheMatrixSleeps) {
+    TestDriver driver;
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    idle_for(60);
+    EXPECT_FALSE(action_macro_playing());
+    EXPECT_FALSE(deadline_pending(DEADLINE_MACRO));
+    EXPECT_TRUE(keyboard_is_idle());
+}
+
+TEST_F(Macro, AFullQueueDropsTheNewEntryWithoutWaiting) {
+    TestDriver driver;
+    static const char str[] = "a";
+    int queued = 0;
+    while (action_macro_send_string(str)) {
+        queued++;
+        ASSERT_LT(queued, 100);
+    }
+    EXPECT_GT(queued, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).Times(queued);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(queued);
+    idle_for(2 * queued + 1);
+    EXPECT_FALSE(action_macro_playing());
+}
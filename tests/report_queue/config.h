@@ -0,0 +1,10 @@
+#ifndef TESTS_REPORT_QUEUE_CONFIG_H_
+#define TESTS_REPORT_QUEUE_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+#define KEYBOARD_REPORT_QUEUE
+#define KEYBOARD_REPORT_QUEUE_SIZE 4
+
+#endif /* TESTS_REPORT_QUEUE_CONFIG_H_ */
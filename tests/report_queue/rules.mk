@@ -0,0 +1 @@
+# Keyboard reports go through the host.c queue
@@ -0,0 +1,139 @@
+#include "test_fixture.h"
+#include "test_driver.h"
+#include "test_matrix.h"
+#include "keyboard_report_util.h"
+extern "C" {
+    #include "keycode.h"
+    #include "host.h"
+}
+
+using testing::_;
+using testing::InSequence;
+using testing::Mock;
+
+/* The endpoint is held busy, so reports pile up in the host.c queue and go
+ * out one per complete_transfer(). */
+class ReportQueue : public TestFixture {};
+
+TEST_F(ReportQueue, ScanLoopKeepsGoingWhileTheEndpointIsBusy) {
+    TestDriver driver;
+    driver.hold_transfers(true);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    // the tap of B stays a tap
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(host_keyboard_queued(), 3);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    driver.complete_transfer();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    driver.complete_transfer();
+    driver.complete_transfer();
+    EXPECT_EQ(host_keyboard_queued(), 0);
+    driver.hold_transfers(false);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ReportQueue, ReleasesInARowAreCoalesced) {
+    TestDriver driver;
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+    idle_for(3);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    driver.hold_transfers(true);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_LSFT)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 0);
+    release_key(2, 0);
+    idle_for(2);
+    EXPECT_EQ(host_keyboard_queued(), 2);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    driver.complete_transfer();
+    driver.hold_transfers(false);
+    driver.complete_transfer();
+}
+
+TEST_F(ReportQueue, PressesAreNotCoalesced) {
+    TestDriver driver;
+    driver.hold_transfers(true);
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(2, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(host_keyboard_queued(), 3);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    driver.complete_transfer();
+    driver.complete_transfer();
+    driver.hold_transfers(false);
+    driver.complete_transfer();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ReportQueue, DuplicatesAreDropped) {
+    TestDriver driver;
+    report_keyboard_t report = {};
+    driver.hold_transfers(true);
+    report.keys[0] = KC_A;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    host_keyboard_send(&report);
+    host_keyboard_send(&report);
+    host_keyboard_send(&report);
+    EXPECT_EQ(host_keyboard_queued(), 1);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    report.keys[0] = KC_NO;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    host_keyboard_send(&report);
+    driver.hold_transfers(false);
+    driver.complete_transfer();
+}
+
+TEST_F(ReportQueue, AFullQueueKeepsTheNewestReport) {
+    TestDriver driver;
+    report_keyboard_t report = {};
+    driver.hold_transfers(true);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(1);
+    // alternating presses and releases, nothing can be coalesced
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_QUEUE_SIZE + 2; i++) {
+        report.keys[0] = (i & 1) ? KC_NO : KC_A + i;
+        host_keyboard_send(&report);
+    }
+    EXPECT_EQ(host_keyboard_queued(), KEYBOARD_REPORT_QUEUE_SIZE + 1);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A + 2)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    driver.hold_transfers(false);
+    driver.complete_transfer();
+}
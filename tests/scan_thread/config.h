@@ -0,0 +1,11 @@
+#ifndef TESTS_SCAN_THREAD_CONFIG_H_
+#define TESTS_SCAN_THREAD_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+#define SCAN_THREAD
+/* small enough to fill up */
+#define SCAN_THREAD_RING_SIZE 4
+
+#endif /* TESTS_SCAN_THREAD_CONFIG_H_ */
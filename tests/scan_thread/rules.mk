@@ -0,0 +1 @@
+# keyboard_scan() and keyboard_task() called separately, as the scan thread does
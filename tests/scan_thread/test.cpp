@@ -0,0 +1,132 @@
+#include "test_fixture.h"
+#include "test_driver.h"
+#include "test_matrix.h"
+#include "keyboard_report_util.h"
+extern "C" {
+    #include "keycode.h"
+    #include "keyboard.h"
+    #include "spsc_ring.h"
+}
+
+using testing::_;
+using testing::InSequence;
+using testing::Mock;
+
+SPSC_RING_DECLARE(test_ring, uint8_t, 8)
+
+TEST(SpscRing, PopsInPushOrder) {
+    test_ring_t ring = {};
+    uint8_t item;
+    for (uint8_t i = 1; i <= 3; i++) {
+        EXPECT_TRUE(test_ring_push(&ring, &i));
+    }
+    EXPECT_EQ(test_ring_count(&ring), 3);
+    for (uint8_t i = 1; i <= 3; i++) {
+        EXPECT_TRUE(test_ring_pop(&ring, &item));
+        EXPECT_EQ(item, i);
+    }
+    EXPECT_FALSE(test_ring_pop(&ring, &item));
+}
+
+TEST(SpscRing, PushFailsWhenFull) {
+    test_ring_t ring = {};
+    uint8_t item;
+    for (uint8_t i = 0; i < 8; i++) {
+        EXPECT_TRUE(test_ring_push(&ring, &i));
+    }
+    item = 8;
+    EXPECT_FALSE(test_ring_push(&ring, &item));
+    EXPECT_TRUE(test_ring_pop(&ring, &item));
+    EXPECT_EQ(item, 0);
+    item = 8;
+    EXPECT_TRUE(test_ring_push(&ring, &item));
+    EXPECT_EQ(test_ring_count(&ring), 8);
+}
+
+TEST(SpscRing, IndicesWrapAround) {
+    test_ring_t ring = {};
+    uint8_t item;
+    // enough to wrap the 8 bit counters more than once
+    for (uint16_t i = 0; i < 600; i++) {
+        uint8_t value = i;
+        uint8_t second = i + 1;
+        EXPECT_TRUE(test_ring_push(&ring, &value));
+        EXPECT_TRUE(test_ring_push(&ring, &second));
+        EXPECT_TRUE(test_ring_pop(&ring, &item));
+        EXPECT_EQ(item, value);
+        EXPECT_TRUE(test_ring_pop(&ring, &item));
+        EXPECT_EQ(item, second);
+        EXPECT_EQ(test_ring_count(&ring), 0);
+    }
+}
+
+TEST(SpscRing, PeekAndClear) {
+    test_ring_t ring = {};
+    for (uint8_t i = 10; i < 13; i++) {
+        test_ring_push(&ring, &i);
+    }
+    EXPECT_EQ(*test_ring_peek(&ring, 0), 10);
+    EXPECT_EQ(*test_ring_peek(&ring, 2), 12);
+    EXPECT_EQ(test_ring_peek(&ring, 3), nullptr);
+    test_ring_clear(&ring);
+    EXPECT_EQ(test_ring_count(&ring), 0);
+    EXPECT_EQ(test_ring_peek(&ring, 0), nullptr);
+}
+
+class ScanThread : public TestFixture {};
+
+TEST_F(ScanThread, ChangesFromSeveralScansKeepTheirOrder) {
+    TestDriver driver;
+    InSequence s;
+    press_key(1, 0);
+    keyboard_scan();
+    press_key(0, 0);
+    keyboard_scan();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    keyboard_task();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    keyboard_task();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    keyboard_task();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 0);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+}
+
+TEST_F(ScanThread, FullRingHoldsChangesBack) {
+    TestDriver driver;
+    InSequence s;
+    for (uint8_t col = 0; col < 6; col++) {
+        press_key(col, 0);
+    }
+    EXPECT_TRUE(keyboard_scan());
+    // nothing new fits until keyboard_task() takes some
+    EXPECT_FALSE(keyboard_scan());
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D)));
+    for (int i = 0; i < 4; i++) {
+        keyboard_task();
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D, KC_E)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D, KC_E, KC_F)));
+    EXPECT_TRUE(keyboard_scan());
+    keyboard_task();
+    keyboard_task();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    for (uint8_t col = 0; col < 6; col++) {
+        release_key(col, 0);
+    }
+    idle_for(6);
+}
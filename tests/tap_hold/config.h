@@ -0,0 +1,11 @@
+#ifndef TESTS_TAP_HOLD_CONFIG_H_
+#define TESTS_TAP_HOLD_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+#define TAPPING_TERM_PER_KEY
+#define PERMISSIVE_HOLD_PER_KEY
+#define HOLD_ON_OTHER_KEY_PRESS_PER_KEY
+
+#endif /* TESTS_TAP_HOLD_CONFIG_H_ */
@@ -0,0 +1,33 @@
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A,         KC_B,         MO(1),        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {SFT_T(KC_P),  ALT_T(KC_Q),  GUI_T(KC_R),  CTL_T(KC_S),  KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+    [1] = {
+        {KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_TRNS,      SFT_T(KC_P),  KC_TRNS,      KC_TRNS,      KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+uint16_t get_tapping_term_user(uint16_t keycode) {
+    switch (keycode) {
+        case ALT_T(KC_Q):
+            return TAPPING_TERM / 2;
+        default:
+            return TAPPING_TERM;
+    }
+}
+
+bool get_permissive_hold_user(uint16_t keycode) {
+    return keycode == GUI_T(KC_R);
+}
+
+bool get_hold_on_other_key_press_user(uint16_t keycode) {
+    return keycode == CTL_T(KC_S);
+}
@@ -0,0 +1 @@
+# Per key tapping terms and tap/hold policies
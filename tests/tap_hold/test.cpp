@@ -0,0 +1,140 @@
+#include "test_fixture.h"
+#include "test_driver.h"
+#include "test_matrix.h"
+#include "keyboard_report_util.h"
+extern "C" {
+    #include "keycode.h"
+    #include "action.h"
+    #include "action_tapping.h"
+}
+
+using testing::_;
+using testing::InSequence;
+using testing::Mock;
+
+/* Row 1: SFT_T(P) with the defaults, ALT_T(Q) with half the tapping term,
+ * GUI_T(R) with permissive hold and CTL_T(S) with hold on other key press.
+ * MO(1) on row 0 puts SFT_T(P) in place of ALT_T(Q). */
+class TapHold : public TestFixture {};
+
+TEST_F(TapHold, ShorterTermIsReportedEarlier) {
+    TestDriver driver;
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM / 2);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(TapHold, DefaultKeyWaitsOutTheTermWhenAnotherKeyIsTyped) {
+    TestDriver driver;
+    press_key(0, 1);
+    run_one_scan_loop();
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 2);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(TapHold, PermissiveHoldIsDecidedByTheOtherKeysRelease) {
+    TestDriver driver;
+    press_key(2, 1);
+    run_one_scan_loop();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LGUI)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_LGUI)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LGUI)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(2, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(TapHold, HoldOnOtherKeyPressIsDecidedByThePress) {
+    TestDriver driver;
+    press_key(3, 1);
+    run_one_scan_loop();
+
+    InSequence s;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_LCTL)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    run_one_scan_loop();
+    release_key(3, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(TapHold, PoliciesLeaveATapATap) {
+    TestDriver driver;
+    InSequence s;
+    press_key(3, 1);
+    run_one_scan_loop();
+    release_key(3, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_S)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(TapHold, TermStaysWithTheKeycodeTappedAcrossALayerChange) {
+    TestDriver driver;
+    InSequence s;
+    press_key(2, 0);
+    run_one_scan_loop();
+    press_key(1, 1);
+    run_one_scan_loop();
+    release_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    /* past the term of ALT_T(Q) now under the key, within that of SFT_T(P),
+     * so the next press still counts as a second tap */
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM * 3 / 4);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
@@ -0,0 +1,10 @@
+#ifndef TESTS_TAPPING_CONFIG_H_
+#define TESTS_TAPPING_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+/* timeouts have to wake the keyboard through their deadlines */
+#define MATRIX_IDLE_SLEEP
+
+#endif /* TESTS_TAPPING_CONFIG_H_ */
@@ -0,0 +1,28 @@
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A,         KC_B,           TD(0),  KC_LEAD, TD(1), TD(2), KC_NO, KC_NO, KC_NO, KC_NO},
+        {SFT_T(KC_P),  OSM(MOD_LSFT),  KC_NO,  KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,          KC_NO,  KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,          KC_NO,  KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+qk_tap_dance_action_t tap_dance_actions[] = {
+    [0] = ACTION_TAP_DANCE_DOUBLE(KC_1, KC_2),
+    [1] = ACTION_TAP_DANCE_DOUBLE_TIME(KC_3, KC_4, TAPPING_TERM / 2),
+    [2] = ACTION_TAP_DANCE_DOUBLE_MAX(KC_5, KC_6),
+};
+
+LEADER_EXTERNS();
+
+void matrix_scan_user(void) {
+    LEADER_DICTIONARY() {
+        leading = false;
+        SEQ_ONE_KEY(KC_A) {
+            register_code(KC_X);
+            unregister_code(KC_X);
+        }
+    }
+}
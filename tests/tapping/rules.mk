@@ -0,0 +1 @@
+TAP_DANCE_ENABLE = yes
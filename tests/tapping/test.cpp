@@ -0,0 +1,210 @@
+#include "test_fixture.h"
+#include "test_driver.h"
+#include "test_matrix.h"
+#include "keyboard_report_util.h"
+extern "C" {
+    #include "keycode.h"
+    #include "action.h"
+    #include "action_tapping.h"
+    #include "process_leader.h"
+    #include "deadline.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+using testing::Mock;
+
+/* Latency of the tapping features, counted in scan ticks from the key event
+ * that decides the outcome to the report that carries it. */
+class Tapping : public TestFixture {};
+
+TEST_F(Tapping, ModTapTapIsReportedOnRelease) {
+    TestDriver driver;
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM / 2);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, ModTapHoldIsReportedWhenTappingTermExpires) {
+    TestDriver driver;
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, ModTapInterruptedByAnotherKeyWaitsForTappingTerm) {
+    TestDriver driver;
+    press_key(0, 1);
+    run_one_scan_loop();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 1);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, OneShotModAppliesToTheNextKey) {
+    TestDriver driver;
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    release_key(1, 1);
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, TapDanceIsResolvedAfterTappingTerm) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2))).Times(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    for (int i = 0; i < 2; i++) {
+        press_key(2, 0);
+        run_one_scan_loop();
+        release_key(2, 0);
+        run_one_scan_loop();
+    }
+    idle_for(TAPPING_TERM - 1);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, TapDanceIsResolvedImmediatelyByAnotherKey) {
+    TestDriver driver;
+    press_key(2, 0);
+    run_one_scan_loop();
+    release_key(2, 0);
+    run_one_scan_loop();
+
+    InSequence s;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_1)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, TapDanceUsesItsOwnTerm) {
+    TestDriver driver;
+    press_key(4, 0);
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM / 2);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_3)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    // nothing left to track
+    EXPECT_FALSE(deadline_pending(DEADLINE_TAP_DANCE));
+}
+
+TEST_F(Tapping, TapDanceFinishesAtItsMaxCount) {
+    TestDriver driver;
+    press_key(5, 0);
+    run_one_scan_loop();
+    release_key(5, 0);
+    run_one_scan_loop();
+
+    InSequence s;
+    press_key(5, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_6)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_FALSE(deadline_pending(DEADLINE_TAP_DANCE));
+
+    release_key(5, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, LeaderSequenceRunsAfterLeaderTimeout) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    press_key(3, 0);
+    run_one_scan_loop();
+    release_key(3, 0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    idle_for(LEADER_TIMEOUT - 3);
+    Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, RollLongerThanTheWaitingBufferIsNotLost) {
+    TestDriver driver;
+    press_key(0, 1);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    for (uint8_t i = 0; i < WAITING_BUFFER_SIZE / 2; i++) {
+        press_key(i % 2, 0);
+        run_one_scan_loop();
+        release_key(i % 2, 0);
+        run_one_scan_loop();
+    }
+    Mock::VerifyAndClearExpectations(&driver);
+
+    // one more event decides the mod tap as held and plays the roll out
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    for (uint8_t i = 0; i < WAITING_BUFFER_SIZE / 2; i++) {
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(i % 2 ? KC_B : KC_A, KC_LSFT)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_LSFT)));
+    press_key(0, 0);
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 1);
+    run_one_scan_loop();
+}
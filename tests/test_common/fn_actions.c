@@ -0,0 +1,9 @@
+/* The test keymaps don't use KC_FN*, every one of them does nothing */
+
+#include "keymap.h"
+#include "action_code.h"
+
+__attribute__ ((weak))
+const uint16_t PROGMEM fn_actions[] = {
+    [0 ... 31] = ACTION_NO
+};
@@ -0,0 +1,58 @@
+#include "keyboard_report_util.h"
+#include <vector>
+#include <algorithm>
+#include <cstring>
+extern "C" {
+    #include "keycode.h"
+}
+
+using namespace testing;
+
+namespace {
+    std::vector<uint8_t> get_keys(const report_keyboard_t& report) {
+        std::vector<uint8_t> result;
+        for (size_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            if (report.keys[i]) {
+                result.emplace_back(report.keys[i]);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+bool operator==(const report_keyboard_t& lhs, const report_keyboard_t& rhs) {
+    return lhs.mods == rhs.mods && get_keys(lhs) == get_keys(rhs);
+}
+
+std::ostream& operator<<(std::ostream& stream, const report_keyboard_t& report) {
+    stream << "Keyboard report: mods 0x" << std::hex << static_cast<unsigned>(report.mods) << " keys";
+    for (uint8_t key : get_keys(report)) {
+        stream << " 0x" << static_cast<unsigned>(key);
+    }
+    return stream << std::dec;
+}
+
+KeyboardReportMatcher::KeyboardReportMatcher(const std::vector<uint8_t>& keys) {
+    memset(&m_report, 0, sizeof(report_keyboard_t));
+    size_t index = 0;
+    for (uint8_t key : keys) {
+        if (IS_MOD(key)) {
+            m_report.mods |= MOD_BIT(key);
+        } else if (index < KEYBOARD_REPORT_KEYS) {
+            m_report.keys[index++] = key;
+        }
+    }
+}
+
+bool KeyboardReportMatcher::MatchAndExplain(const report_keyboard_t& report, MatchResultListener* listener) const {
+    return m_report == report;
+}
+
+void KeyboardReportMatcher::DescribeTo(::std::ostream* os) const {
+    *os << "is equal to " << m_report;
+}
+
+void KeyboardReportMatcher::DescribeNegationTo(::std::ostream* os) const {
+    *os << "is not equal to " << m_report;
+}
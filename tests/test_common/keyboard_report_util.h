@@ -0,0 +1,32 @@
+#ifndef TESTS_TEST_COMMON_KEYBOARD_REPORT_UTIL_H_
+#define TESTS_TEST_COMMON_KEYBOARD_REPORT_UTIL_H_
+
+#include <vector>
+#include <ostream>
+#include "gmock/gmock.h"
+extern "C" {
+    #include "report.h"
+}
+
+bool operator==(const report_keyboard_t& lhs, const report_keyboard_t& rhs);
+std::ostream& operator<<(std::ostream& stream, const report_keyboard_t& value);
+
+/* Matches a keyboard report containing exactly the given keys, modifier
+ * keycodes (KC_LCTL..KC_RGUI) are checked against the mods byte and the order
+ * of the other keys does not matter. */
+class KeyboardReportMatcher : public testing::MatcherInterface<const report_keyboard_t&> {
+public:
+    KeyboardReportMatcher(const std::vector<uint8_t>& keys);
+    virtual bool MatchAndExplain(const report_keyboard_t& report, testing::MatchResultListener* listener) const override;
+    virtual void DescribeTo(::std::ostream* os) const override;
+    virtual void DescribeNegationTo(::std::ostream* os) const override;
+private:
+    report_keyboard_t m_report;
+};
+
+template<typename... Ts>
+inline testing::Matcher<const report_keyboard_t&> KeyboardReport(Ts... keys) {
+    return testing::MakeMatcher(new KeyboardReportMatcher(std::vector<uint8_t>({static_cast<uint8_t>(keys)...})));
+}
+
+#endif /* TESTS_TEST_COMMON_KEYBOARD_REPORT_UTIL_H_ */
@@ -0,0 +1,56 @@
+/* Simulated matrix, the tests press and release keys directly in it */
+
+#include <string.h>
+
+#include "matrix.h"
+#include "test_matrix.h"
+
+static matrix_row_t matrix[MATRIX_ROWS] = {};
+
+__attribute__ ((weak))
+void matrix_init_user(void) {}
+
+__attribute__ ((weak))
+void matrix_scan_user(void) {}
+
+__attribute__ ((weak))
+void matrix_init_kb(void) {
+    matrix_init_user();
+}
+
+__attribute__ ((weak))
+void matrix_scan_kb(void) {
+    matrix_scan_user();
+}
+
+void matrix_init(void) {
+    clear_all_keys();
+    matrix_init_quantum();
+}
+
+uint8_t matrix_scan(void) {
+    matrix_scan_quantum();
+    return 1;
+}
+
+matrix_row_t matrix_get_row(uint8_t row) {
+    return matrix[row];
+}
+
+bool matrix_is_on(uint8_t row, uint8_t col) {
+    return matrix[row] & ((matrix_row_t)1 << col);
+}
+
+void matrix_print(void) {}
+
+void press_key(uint8_t col, uint8_t row) {
+    matrix[row] |= (matrix_row_t)1 << col;
+}
+
+void release_key(uint8_t col, uint8_t row) {
+    matrix[row] &= ~((matrix_row_t)1 << col);
+}
+
+void clear_all_keys(void) {
+    memset(matrix, 0, sizeof(matrix));
+}
@@ -0,0 +1,46 @@
+#include "test_driver.h"
+
+TestDriver* TestDriver::m_this = nullptr;
+
+TestDriver::TestDriver()
+    : m_driver{
+        &TestDriver::keyboard_leds,
+        &TestDriver::send_keyboard,
+        &TestDriver::send_mouse,
+        &TestDriver::send_system,
+        &TestDriver::send_consumer
+    }
+{
+    host_set_driver(&m_driver);
+    m_this = this;
+}
+
+TestDriver::~TestDriver() {
+    host_set_driver(nullptr);
+    m_this = nullptr;
+}
+
+uint8_t TestDriver::keyboard_leds(void) {
+    return m_this->m_leds;
+}
+
+void TestDriver::send_keyboard(report_keyboard_t* report) {
+    m_this->send_keyboard_mock(*report);
+#ifdef KEYBOARD_REPORT_QUEUE
+    if (!m_this->m_hold_transfers) {
+        host_keyboard_sent();
+    }
+#endif
+}
+
+void TestDriver::send_mouse(report_mouse_t* report) {
+    m_this->send_mouse_mock(*report);
+}
+
+void TestDriver::send_system(uint16_t data) {
+    m_this->send_system_mock(data);
+}
+
+void TestDriver::send_consumer(uint16_t data) {
+    m_this->send_consumer_mock(data);
+}
@@ -0,0 +1,43 @@
+#ifndef TESTS_TEST_COMMON_TEST_DRIVER_H_
+#define TESTS_TEST_COMMON_TEST_DRIVER_H_
+
+#include "gmock/gmock.h"
+#include <stdint.h>
+extern "C" {
+    #include "host.h"
+}
+#include "keyboard_report_util.h"
+
+/* Mock host driver, every report the keyboard sends ends up in one of the
+ * mocked methods so the tests can set expectations on them. */
+class TestDriver {
+public:
+    TestDriver();
+    ~TestDriver();
+    void set_leds(uint8_t leds) { m_leds = leds; }
+#ifdef KEYBOARD_REPORT_QUEUE
+    /* Keep the keyboard endpoint busy after each report until complete_transfer(),
+     * by default every report is taken at once. */
+    void hold_transfers(bool hold) { m_hold_transfers = hold; }
+    void complete_transfer(void) { host_keyboard_sent(); }
+#endif
+
+    MOCK_METHOD1(send_keyboard_mock, void (const report_keyboard_t&));
+    MOCK_METHOD1(send_mouse_mock, void (const report_mouse_t&));
+    MOCK_METHOD1(send_system_mock, void (uint16_t));
+    MOCK_METHOD1(send_consumer_mock, void (uint16_t));
+private:
+    static uint8_t keyboard_leds(void);
+    static void send_keyboard(report_keyboard_t* report);
+    static void send_mouse(report_mouse_t* report);
+    static void send_system(uint16_t data);
+    static void send_consumer(uint16_t data);
+    host_driver_t m_driver;
+    uint8_t m_leds = 0;
+#ifdef KEYBOARD_REPORT_QUEUE
+    bool m_hold_transfers = false;
+#endif
+    static TestDriver* m_this;
+};
+
+#endif /* TESTS_TEST_COMMON_TEST_DRIVER_H_ */
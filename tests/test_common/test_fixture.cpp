@@ -0,0 +1,58 @@
+#include "test_fixture.h"
+#include "gmock/gmock.h"
+#include "test_driver.h"
+#include "test_matrix.h"
+extern "C" {
+    #include "keyboard.h"
+    #include "action.h"
+    #include "action_layer.h"
+    #include "action_util.h"
+    #include "action_tapping.h"
+    #include "timer_test.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Mock;
+
+void TestFixture::SetUpTestCase() {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    keyboard_init();
+}
+
+void TestFixture::TearDownTestCase() {
+}
+
+TestFixture::TestFixture() {
+    /* Start every test at the same point in time so tick counts are exact */
+    set_time(0);
+}
+
+TestFixture::~TestFixture() {
+    TestDriver driver;
+    /* Let anything still held or pending (tapping, one shot) time out */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    clear_all_keys();
+    idle_for(TAPPING_TERM * 10);
+    clear_keyboard();
+    layer_clear();
+    Mock::VerifyAndClearExpectations(&driver);
+    /* With nothing pressed the keyboard must stay silent */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM * 10);
+}
+
+void TestFixture::run_one_scan_loop() {
+#ifdef SCAN_THREAD
+    keyboard_scan();
+#endif
+    keyboard_task();
+    advance_time(1);
+}
+
+void TestFixture::idle_for(unsigned scans) {
+    for (unsigned i = 0; i < scans; i++) {
+        run_one_scan_loop();
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef TESTS_TEST_COMMON_TEST_FIXTURE_H_
+#define TESTS_TEST_COMMON_TEST_FIXTURE_H_
+
+#include "gtest/gtest.h"
+
+/* Base fixture for the full keyboard tests. Each scan loop runs one
+ * keyboard_task() and then advances the simulated clock by one millisecond,
+ * so latencies can be expressed in scan ticks. */
+class TestFixture : public testing::Test {
+public:
+    TestFixture();
+    ~TestFixture();
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+
+    void run_one_scan_loop();
+    void idle_for(unsigned scans);
+};
+
+#endif /* TESTS_TEST_COMMON_TEST_FIXTURE_H_ */
@@ -26,6 +26,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_macro.h"
 #include "action_util.h"
 #include "action.h"
+#include "keymap.h"
+#include "bench.h"
 
 #ifdef DEBUG_ACTION
 #include "debug.h"
@@ -96,7 +98,7 @@ void process_record_nocache(keyrecord_t *record)
 #endif
 
 __attribute__ ((weak))
-bool process_record_quantum(keyrecord_t *record) {
+bool process_record_quantum(keyrecord_t *record, keylookup_t *lookup) {
     return true;
 }
 
@@ -104,18 +106,26 @@ void process_record(keyrecord_t *record)
 {
     if (IS_NOEVENT(record->event)) { return; }
 
-    if(!process_record_quantum(record))
+    keylookup_t lookup;
+    // one layer resolution and cache update per event
+    lookup.layer = store_or_get_layer(record->event.pressed, record->event.key);
+    lookup.keycode = keymap_key_to_keycode(lookup.layer, record->event.key);
+
+    BENCH_START(quantum_start);
+    bool quantum_continue = process_record_quantum(record, &lookup);
+    BENCH_END(BENCH_PROCESS_RECORD_QUANTUM, quantum_start);
+    if (!quantum_continue)
         return;
 
-    action_t action = store_or_get_action(record->event.pressed, record->event.key);
-    dprint("ACTION: "); debug_action(action);
+    lookup.action = action_for_key(lookup.layer, record->event.key);
+    dprint("ACTION: "); debug_action(lookup.action);
 #ifndef NO_ACTION_LAYER
     dprint(" layer_state: "); layer_debug();
     dprint(" default_layer_state: "); default_layer_debug();
 #endif
     dprintln();
 
-    process_action(record, action);
+    process_action(record, lookup.action);
 }
 
 void process_action(keyrecord_t *record, action_t action)
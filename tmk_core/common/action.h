@@ -46,6 +46,16 @@ typedef struct {
 #endif
 } keyrecord_t;
 
+/* Keymap lookup of a record, done once in process_record() and shared by
+ * process_record_quantum() and process_action(). The action is only
+ * decoded once process_record_quantum() lets the event through.
+ */
+typedef struct {
+    uint8_t  layer;
+    uint16_t keycode;
+    action_t action;
+} keylookup_t;
+
 /* Execute action per keyevent */
 void action_exec(keyevent_t event);
 
@@ -59,7 +69,7 @@ const macro_t *action_get_macro(keyrecord_t *record, uint8_t id, uint8_t opt);
 void action_function(keyrecord_t *record, uint8_t id, uint8_t opt);
 
 /* keyboard-specific key event (pre)processing */
-bool process_record_quantum(keyrecord_t *record);
+bool process_record_quantum(keyrecord_t *record, keylookup_t *lookup);
 
 /* Utilities for actions.  */
 #if !defined(NO_ACTION_LAYER) && defined(PREVENT_STUCK_MODIFIERS)
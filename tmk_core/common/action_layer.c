@@ -1,4 +1,7 @@
 #include <stdint.h>
+#if defined(__AVR__)
+#include <avr/io.h>
+#endif
 #include "keyboard.h"
 #include "action.h"
 #include "util.h"
@@ -111,6 +114,24 @@ void layer_debug(void)
 #endif
 
 #if !defined(NO_ACTION_LAYER) && defined(PREVENT_STUCK_MODIFIERS)
+/*
+ * Layout of source_layers_cache, pick one in config.h:
+ *   SOURCE_LAYERS_CACHE_SLICED  MAX_LAYER_BITS planes of one bit per key,
+ *                               least RAM but every access loops over planes
+ *   SOURCE_LAYERS_CACHE_PACKED  a byte per key, or a nibble when
+ *                               MAX_LAYER_BITS <= 4, read with a single load
+ * By default the packed layout is used unless it would take more than 1/32
+ * of the SRAM of an AVR.
+ */
+#if !defined(SOURCE_LAYERS_CACHE_SLICED) && !defined(SOURCE_LAYERS_CACHE_PACKED)
+#   if defined(__AVR__) && (MATRIX_ROWS * MATRIX_COLS * 32 > RAMEND - RAMSTART + 1)
+#       define SOURCE_LAYERS_CACHE_SLICED
+#   else
+#       define SOURCE_LAYERS_CACHE_PACKED
+#   endif
+#endif
+
+#if defined(SOURCE_LAYERS_CACHE_SLICED)
 uint8_t source_layers_cache[(MATRIX_ROWS * MATRIX_COLS + 7) / 8][MAX_LAYER_BITS] = {{0}};
 
 void update_source_layers_cache(keypos_t key, uint8_t layer)
@@ -143,6 +164,37 @@ uint8_t read_source_layers_cache(keypos_t key)
 
     return layer;
 }
+#elif (MAX_LAYER_BITS <= 4)
+uint8_t source_layers_cache[(MATRIX_ROWS * MATRIX_COLS + 1) / 2] = {0};
+
+void update_source_layers_cache(keypos_t key, uint8_t layer)
+{
+    const uint16_t key_number = key.col + (key.row * MATRIX_COLS);
+    const uint8_t shift = (key_number & 1) * 4;
+
+    source_layers_cache[key_number / 2] =
+        (source_layers_cache[key_number / 2] & ~(0x0F << shift)) | ((layer & 0x0F) << shift);
+}
+
+uint8_t read_source_layers_cache(keypos_t key)
+{
+    const uint16_t key_number = key.col + (key.row * MATRIX_COLS);
+
+    return (source_layers_cache[key_number / 2] >> ((key_number & 1) * 4)) & 0x0F;
+}
+#else
+uint8_t source_layers_cache[MATRIX_ROWS * MATRIX_COLS] = {0};
+
+void update_source_layers_cache(keypos_t key, uint8_t layer)
+{
+    source_layers_cache[key.col + (key.row * MATRIX_COLS)] = layer;
+}
+
+uint8_t read_source_layers_cache(keypos_t key)
+{
+    return source_layers_cache[key.col + (key.row * MATRIX_COLS)];
+}
+#endif
 #endif
 
 /*
@@ -151,11 +203,11 @@ uint8_t read_source_layers_cache(keypos_t key)
  * when the layer is switched after the down event but before the up
  * event as they may get stuck otherwise.
  */
-action_t store_or_get_action(bool pressed, keypos_t key)
+uint8_t store_or_get_layer(bool pressed, keypos_t key)
 {
 #if !defined(NO_ACTION_LAYER) && defined(PREVENT_STUCK_MODIFIERS)
     if (disable_action_cache) {
-        return layer_switch_get_action(key);
+        return layer_switch_get_layer(key);
     }
 
     uint8_t layer;
@@ -167,20 +219,24 @@ action_t store_or_get_action(bool pressed, keypos_t key)
     else {
         layer = read_source_layers_cache(key);
     }
-    return action_for_key(layer, key);
+    return layer;
 #else
-    return layer_switch_get_action(key);
+    return layer_switch_get_layer(key);
 #endif
 }
 
+action_t store_or_get_action(bool pressed, keypos_t key)
+{
+    return action_for_key(store_or_get_layer(pressed, key), key);
+}
 
-int8_t layer_switch_get_layer(keypos_t key)
+
+#ifndef NO_ACTION_LAYER
+/* topmost layer in `layers` whose action for key isn't transparent */
+static int8_t layer_switch_resolve(uint32_t layers, keypos_t key)
 {
     action_t action;
-    action.code = ACTION_TRANSPARENT;
 
-#ifndef NO_ACTION_LAYER
-    uint32_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = 31; i >= 0; i--) {
         if (layers & (1UL<<i)) {
@@ -192,6 +248,57 @@ int8_t layer_switch_get_layer(keypos_t key)
     }
     /* fall back to layer 0 */
     return 0;
+}
+#endif
+
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_RESOLUTION_CACHE)
+/*
+ * Resolved layer per key for the layer state in resolved_state. Entries are
+ * filled on first use and all dropped together when the state changes, so
+ * only the keys actually pressed on a layer combination pay for the walk.
+ */
+static uint8_t resolved_layers[MATRIX_ROWS * MATRIX_COLS];
+static uint8_t resolved_valid[(MATRIX_ROWS * MATRIX_COLS + 7) / 8];
+static uint32_t resolved_state = 0;
+
+void layer_cache_invalidate(void)
+{
+    for (uint8_t i = 0; i < sizeof(resolved_valid); i++) {
+        resolved_valid[i] = 0;
+    }
+}
+
+static int8_t layer_cache_get_layer(uint32_t layers, keypos_t key)
+{
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+        return layer_switch_resolve(layers, key);
+    }
+
+    if (layers != resolved_state) {
+        layer_cache_invalidate();
+        resolved_state = layers;
+    }
+
+    const uint16_t key_number = key.col + (key.row * MATRIX_COLS);
+    const uint8_t valid_bit = 1U << (key_number % 8);
+
+    if (!(resolved_valid[key_number / 8] & valid_bit)) {
+        resolved_layers[key_number] = layer_switch_resolve(layers, key);
+        resolved_valid[key_number / 8] |= valid_bit;
+    }
+    return resolved_layers[key_number];
+}
+#endif
+
+int8_t layer_switch_get_layer(keypos_t key)
+{
+#ifndef NO_ACTION_LAYER
+    uint32_t layers = layer_state | default_layer_state;
+#   ifdef LAYER_RESOLUTION_CACHE
+    return layer_cache_get_layer(layers, key);
+#   else
+    return layer_switch_resolve(layers, key);
+#   endif
 #else
     return biton32(default_layer_state);
 #endif
@@ -73,16 +73,27 @@ void layer_xor(uint32_t state);
 
 /* pressed actions cache */
 #if !defined(NO_ACTION_LAYER) && defined(PREVENT_STUCK_MODIFIERS)
-/* The number of bits needed to represent the layer number: log2(32). */
+/* The number of bits needed to represent the layer number: log2(32).
+ * Keymaps with no more than 16 layers can lower it to 4 to halve the cache. */
+#ifndef MAX_LAYER_BITS
 #define MAX_LAYER_BITS 5
+#endif
 void update_source_layers_cache(keypos_t key, uint8_t layer);
 uint8_t read_source_layers_cache(keypos_t key);
 #endif
+uint8_t store_or_get_layer(bool pressed, keypos_t key);
 action_t store_or_get_action(bool pressed, keypos_t key);
 
 /* return the topmost non-transparent layer currently associated with key */
 int8_t layer_switch_get_layer(keypos_t key);
 
+/* resolved layer cache, call when keymap contents change at runtime */
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_RESOLUTION_CACHE)
+void layer_cache_invalidate(void);
+#else
+#define layer_cache_invalidate()
+#endif
+
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
 
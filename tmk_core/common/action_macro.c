@@ -14,10 +14,13 @@ GNU General Public License for more details.
 You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
+#include <stddef.h>
 #include "action.h"
 #include "action_util.h"
 #include "action_macro.h"
 #include "wait.h"
+#include "deadline.h"
+#include "host.h"
 
 #ifdef DEBUG_ACTION
 #include "debug.h"
@@ -29,57 +32,246 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef NO_ACTION_MACRO
 
 #define MACRO_READ()  (macro = MACRO_GET(macro_p++))
-void action_macro_play(const macro_t *macro_p)
+/* Runs the command at *macro_pp and moves it past that command.
+ * WAIT(ms) is returned in *wait instead of being waited for.
+ * Returns false on END.
+ */
+static bool macro_command(const macro_t **macro_pp, uint8_t *interval, uint8_t *wait)
 {
+    const macro_t *macro_p = *macro_pp;
     macro_t macro = END;
+
+    *wait = 0;
+    switch (MACRO_READ()) {
+        case KEY_DOWN:
+            MACRO_READ();
+            dprintf("KEY_DOWN(%02X)\n", macro);
+            if (IS_MOD(macro)) {
+                add_macro_mods(MOD_BIT(macro));
+                send_keyboard_report();
+            } else {
+                register_code(macro);
+            }
+            break;
+        case KEY_UP:
+            MACRO_READ();
+            dprintf("KEY_UP(%02X)\n", macro);
+            if (IS_MOD(macro)) {
+                del_macro_mods(MOD_BIT(macro));
+                send_keyboard_report();
+            } else {
+                unregister_code(macro);
+            }
+            break;
+        case WAIT:
+            MACRO_READ();
+            dprintf("WAIT(%u)\n", macro);
+            *wait = macro;
+            break;
+        case INTERVAL:
+            *interval = MACRO_READ();
+            dprintf("INTERVAL(%u)\n", *interval);
+            break;
+        case 0x04 ... 0x73:
+            dprintf("DOWN(%02X)\n", macro);
+            register_code(macro);
+            break;
+        case 0x84 ... 0xF3:
+            dprintf("UP(%02X)\n", macro);
+            unregister_code(macro&0x7F);
+            break;
+        case END:
+        default:
+            return false;
+    }
+    *macro_pp = macro_p;
+    return true;
+}
+
+#ifndef NONBLOCKING_MACROS
+void action_macro_play(const macro_t *macro_p)
+{
     uint8_t interval = 0;
+    uint8_t wait;
 
     if (!macro_p) return;
-    while (true) {
-        switch (MACRO_READ()) {
-            case KEY_DOWN:
-                MACRO_READ();
-                dprintf("KEY_DOWN(%02X)\n", macro);
-                if (IS_MOD(macro)) {
-                    add_macro_mods(MOD_BIT(macro));
-                    send_keyboard_report();
-                } else {
-                    register_code(macro);
-                }
-                break;
-            case KEY_UP:
-                MACRO_READ();
-                dprintf("KEY_UP(%02X)\n", macro);
-                if (IS_MOD(macro)) {
-                    del_macro_mods(MOD_BIT(macro));
-                    send_keyboard_report();
-                } else {
-                    unregister_code(macro);
-                }
-                break;
-            case WAIT:
-                MACRO_READ();
-                dprintf("WAIT(%u)\n", macro);
-                { uint8_t ms = macro; while (ms--) wait_ms(1); }
-                break;
-            case INTERVAL:
-                interval = MACRO_READ();
-                dprintf("INTERVAL(%u)\n", interval);
-                break;
-            case 0x04 ... 0x73:
-                dprintf("DOWN(%02X)\n", macro);
-                register_code(macro);
-                break;
-            case 0x84 ... 0xF3:
-                dprintf("UP(%02X)\n", macro);
-                unregister_code(macro&0x7F);
-                break;
-            case END:
-            default:
-                return;
-        }
+    while (macro_command(&macro_p, &interval, &wait)) {
+        while (wait--) wait_ms(1);
         // interval
         { uint8_t ms = interval; while (ms--) wait_ms(1); }
     }
 }
 #endif
+#endif
+
+#ifdef NONBLOCKING_MACROS
+/* Macro player
+ *
+ * action_macro_play() and action_macro_send_string() queue their input and
+ * return at once. action_macro_task() runs one step per call once the report
+ * of the previous step has left the endpoint, so every report gets its own
+ * poll slot and the keyboard keeps scanning in the meantime. Only WAIT and
+ * INTERVAL are timed, with DEADLINE_MACRO instead of busy waiting.
+ */
+#ifndef MACRO_QUEUE_SIZE
+#   define MACRO_QUEUE_SIZE 8
+#endif
+
+/* one of macro or str is set, both are NULL for an empty entry */
+typedef struct {
+    const macro_t *macro;
+    const char *str;
+} macro_source_t;
+
+static macro_source_t queue[MACRO_QUEUE_SIZE];
+static uint8_t queue_head = 0;
+static uint8_t queue_count = 0;
+
+static macro_source_t playing = { NULL, NULL };
+static uint8_t playing_interval = 0;
+/* progress within the current character of a string */
+static uint8_t string_phase = 0;
+
+__attribute__ ((weak))
+bool macro_ascii_to_keycode(uint8_t ascii, uint8_t *keycode)
+{
+    (void)ascii;
+    *keycode = KC_NO;
+    return false;
+}
+
+/* Types the current string one report at a time. Returns false at its end. */
+static bool string_step(void)
+{
+    uint8_t ascii = pgm_read_byte(playing.str);
+    uint8_t keycode;
+    bool shift;
+
+    if (!ascii) return false;
+    shift = macro_ascii_to_keycode(ascii, &keycode);
+    switch (string_phase++) {
+        case 0:
+            if (shift) {
+                register_code(KC_LSFT);
+                break;
+            }
+            string_phase++;
+            /* fall through */
+        case 1:
+            register_code(keycode);
+            break;
+        case 2:
+            unregister_code(keycode);
+            if (shift) break;
+            /* fall through */
+        default:
+            if (shift) unregister_code(KC_LSFT);
+            string_phase = 0;
+            playing.str++;
+            break;
+    }
+    return true;
+}
+
+static bool source_finished(void)
+{
+    if (playing.str) {
+        return !string_phase && !pgm_read_byte(playing.str);
+    }
+#ifndef NO_ACTION_MACRO
+    if (playing.macro) {
+        return MACRO_GET(playing.macro) == END;
+    }
+#endif
+    return true;
+}
+
+static bool queue_source(macro_source_t source)
+{
+    // dropping the whole entry keeps what is queued intact and in order
+    if (queue_count == MACRO_QUEUE_SIZE) {
+        dprint("macro queue full\n");
+        return false;
+    }
+    queue[(queue_head + queue_count) % MACRO_QUEUE_SIZE] = source;
+    queue_count++;
+    return true;
+}
+
+#ifndef NO_ACTION_MACRO
+bool action_macro_play(const macro_t *macro_p)
+{
+    if (!macro_p) return true;
+    return queue_source((macro_source_t){ .macro = macro_p, .str = NULL });
+}
+#endif
+
+bool action_macro_send_string(const char *str)
+{
+    if (!str) return true;
+    return queue_source((macro_source_t){ .macro = NULL, .str = str });
+}
+
+bool action_macro_playing(void)
+{
+    return playing.macro || playing.str || queue_count;
+}
+
+/* the report of the previous step has been taken by the endpoint */
+static bool endpoint_ready(void)
+{
+#ifdef KEYBOARD_REPORT_QUEUE
+    return !host_keyboard_queued();
+#else
+    // the driver waits for the endpoint in send_keyboard()
+    return true;
+#endif
+}
+
+void action_macro_task(void)
+{
+    if (deadline_pending(DEADLINE_MACRO)) {
+        if (!deadline_due(DEADLINE_MACRO)) return;
+        deadline_cancel(DEADLINE_MACRO);
+    }
+    if (!endpoint_ready()) return;
+
+    while (true) {
+        uint8_t wait = 0;
+        bool more = false;
+
+        if (!playing.macro && !playing.str) {
+            if (!queue_count) return;
+            playing = queue[queue_head];
+            queue_head = (queue_head + 1) % MACRO_QUEUE_SIZE;
+            queue_count--;
+            playing_interval = 0;
+            string_phase = 0;
+        }
+
+        if (playing.str) {
+            more = string_step();
+        }
+#ifndef NO_ACTION_MACRO
+        else {
+            more = macro_command(&playing.macro, &playing_interval, &wait);
+        }
+#endif
+        if (more) {
+            uint16_t delay = wait + playing_interval;
+            if (delay) {
+                deadline_set_in(DEADLINE_MACRO, delay);
+            }
+            // let key changes through as soon as the last step is out
+            if (source_finished()) {
+                playing.macro = NULL;
+                playing.str = NULL;
+            }
+            return;
+        }
+        // finished, start the next entry right away
+        playing.macro = NULL;
+        playing.str = NULL;
+    }
+}
+#endif
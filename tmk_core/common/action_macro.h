@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef ACTION_MACRO_H
 #define ACTION_MACRO_H
 #include <stdint.h>
+#include <stdbool.h>
 #include "progmem.h"
 
 
@@ -28,11 +29,28 @@ typedef uint8_t macro_t;
 
 
 #ifndef NO_ACTION_MACRO
+#ifdef NONBLOCKING_MACROS
+/* false if the queue is full and the macro was dropped, try again later */
+bool action_macro_play(const macro_t *macro_p);
+#else
 void action_macro_play(const macro_t *macro_p);
+#endif
 #else
 #define action_macro_play(macro)
 #endif
 
+#ifdef NONBLOCKING_MACROS
+/* queue a PROGMEM string to be typed, see send_string(), false if the queue
+ * is full and the string was dropped */
+bool action_macro_send_string(const char *str);
+/* true while anything is queued or playing */
+bool action_macro_playing(void);
+/* play the next step, called from keyboard_task() */
+void action_macro_task(void);
+/* keycode for an ascii character, returns true if it needs shift */
+bool macro_ascii_to_keycode(uint8_t ascii, uint8_t *keycode);
+#endif
+
 
 
 /* Macro commands
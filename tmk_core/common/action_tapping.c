@@ -5,6 +5,8 @@
 #include "action_tapping.h"
 #include "keycode.h"
 #include "timer.h"
+#include "deadline.h"
+#include "spsc_ring.h"
 
 #ifdef DEBUG_ACTION
 #include "debug.h"
@@ -18,17 +20,60 @@
 #define IS_TAPPING_PRESSED()    (IS_TAPPING() && tapping_key.event.pressed)
 #define IS_TAPPING_RELEASED()   (IS_TAPPING() && !tapping_key.event.pressed)
 #define IS_TAPPING_KEY(k)       (IS_TAPPING() && KEYEQ(tapping_key.event.key, (k)))
-#define WITHIN_TAPPING_TERM(e)  (TIMER_DIFF_16(e.time, tapping_key.event.time) < TAPPING_TERM)
+#define WITHIN_TAPPING_TERM(e)  (TIMER_DIFF_16(e.time, tapping_key.event.time) < TAPPING_KEY_TERM)
+
+#ifdef TAPPING_TERM_PER_KEY
+#   define TAPPING_KEY_TERM             tapping_settings.term
+#else
+#   define TAPPING_KEY_TERM             TAPPING_TERM
+#endif
+#if defined(PERMISSIVE_HOLD) || TAPPING_TERM >= 500
+#   define TAPPING_KEY_PERMISSIVE_HOLD  true
+#elif defined(PERMISSIVE_HOLD_PER_KEY)
+#   define TAPPING_KEY_PERMISSIVE_HOLD  tapping_settings.permissive_hold
+#else
+#   define TAPPING_KEY_PERMISSIVE_HOLD  false
+#endif
+#if defined(HOLD_ON_OTHER_KEY_PRESS)
+#   define TAPPING_KEY_HOLD_ON_OTHER    true
+#elif defined(HOLD_ON_OTHER_KEY_PRESS_PER_KEY)
+#   define TAPPING_KEY_HOLD_ON_OTHER    tapping_settings.hold_on_other_key_press
+#else
+#   define TAPPING_KEY_HOLD_ON_OTHER    false
+#endif
 
 
 static keyrecord_t tapping_key = {};
-static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
-static uint8_t waiting_buffer_head = 0;
-static uint8_t waiting_buffer_tail = 0;
+/* looked up when tapping_key is pressed, so a layer change while it's held
+ * can't give it the settings of whatever key is under it now */
+static tapping_settings_t tapping_settings = { .term = TAPPING_TERM };
+
+/* Waiting buffer
+ *
+ * Key events held back while the tapping key is undecided. Counts kept up as
+ * events come and go answer the per event questions without a scan: how
+ * many buffered events are presses, and per key how many presses and
+ * releases are buffered, a nibble each.
+ */
+#if WAITING_BUFFER_SIZE > 16
+#   error "WAITING_BUFFER_SIZE is limited to 16"
+#endif
+SPSC_RING_DECLARE(waiting_ring, keyrecord_t, WAITING_BUFFER_SIZE)
+
+#define WAITING_KEY_STEP(pressed)   ((pressed) ? 0x10 : 0x01)
+#define WAITING_KEY_PRESSES(index)  ((index) >> 4)
+#define WAITING_KEY_RELEASES(index) ((index) & 0x0F)
+#define WAITING_KEY_INDEXED(k)      ((k).row < MATRIX_ROWS && (k).col < MATRIX_COLS)
+
+static waiting_ring_t waiting_buffer = {};
+static uint8_t waiting_pressed_count = 0;
+static uint8_t waiting_keys[MATRIX_ROWS][MATRIX_COLS] = {};
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_deq(void);
 static void waiting_buffer_clear(void);
+static void waiting_buffer_settle(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
 static void waiting_buffer_scan_tap(void);
@@ -36,6 +81,19 @@ static void debug_tapping_key(void);
 static void debug_waiting_buffer(void);
 
 
+__attribute__ ((weak))
+void get_tapping_settings(keypos_t key, tapping_settings_t *settings)
+{
+}
+
+/* a new press becomes the tapping key, with its settings */
+static void tapping_key_press(const keyrecord_t *keyp)
+{
+    tapping_key = *keyp;
+    tapping_settings = (tapping_settings_t){ .term = TAPPING_TERM };
+    get_tapping_settings(keyp->event.key, &tapping_settings);
+}
+
 void action_tapping_process(keyrecord_t record)
 {
     if (process_tapping(&record)) {
@@ -44,26 +102,40 @@ void action_tapping_process(keyrecord_t record)
         }
     } else {
         if (!waiting_buffer_enq(record)) {
-            // clear all in case of overflow.
-            debug("OVERFLOW: CLEAR ALL STATES\n");
-            clear_keyboard();
-            waiting_buffer_clear();
-            tapping_key = (keyrecord_t){};
+            // a roll longer than the buffer, decide the tapping key as held
+            // and play the buffer out rather than drop keys
+            debug("OVERFLOW: SETTLE TAPPING KEY\n");
+            waiting_buffer_settle();
+            if (!process_tapping(&record) && !waiting_buffer_enq(record)) {
+                // clear all in case of overflow.
+                debug("OVERFLOW: CLEAR ALL STATES\n");
+                clear_keyboard();
+                waiting_buffer_clear();
+                tapping_key = (keyrecord_t){};
+            }
         }
     }
 
     // process waiting_buffer
-    if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
+    if (!IS_NOEVENT(record.event) && waiting_ring_count(&waiting_buffer)) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
-            debug("processed: waiting_buffer["); debug_dec(waiting_buffer_tail); debug("] = ");
-            debug_record(waiting_buffer[waiting_buffer_tail]); debug("\n\n");
+    for (keyrecord_t *waiting; (waiting = waiting_ring_peek(&waiting_buffer, 0)); waiting_buffer_deq()) {
+        if (process_tapping(waiting)) {
+            debug("processed: waiting_buffer = "); debug_record(*waiting); debug("\n\n");
         } else {
             break;
         }
     }
+
+    // the next TICK that can decide the tapping key, TICK times are odd so allow one early
+    if (IS_TAPPING()) {
+        int16_t since_event = (int16_t)(timer_read() - tapping_key.event.time);
+        deadline_set(DEADLINE_TAPPING, timer_read32() - since_event + TAPPING_KEY_TERM - 1);
+    } else {
+        deadline_cancel(DEADLINE_TAPPING);
+    }
+
     if (!IS_NOEVENT(record.event)) {
         debug("\n");
     }
@@ -96,12 +168,13 @@ bool process_tapping(keyrecord_t *keyp)
                     // enqueue
                     return false;
                 }
-#if TAPPING_TERM >= 500
                 /* Process a key typed within TAPPING_TERM
                  * This can register the key before settlement of tapping,
                  * useful for long TAPPING_TERM but may prevent fast typing.
+                 * Always on with TAPPING_TERM >= 500, see PERMISSIVE_HOLD.
                  */
-                else if (IS_RELEASED(event) && waiting_buffer_typed(event)) {
+                else if (IS_RELEASED(event) && TAPPING_KEY_PERMISSIVE_HOLD &&
+                         waiting_buffer_typed(event)) {
                     debug("Tapping: End. No tap. Interfered by typing key\n");
                     process_record(&tapping_key);
                     tapping_key = (keyrecord_t){};
@@ -109,7 +182,6 @@ bool process_tapping(keyrecord_t *keyp)
                     // enqueue
                     return false;
                 }
-#endif
                 /* Process release event of a key pressed before tapping starts
                  * Without this unexpected repeating will occur with having fast repeating setting
                  * https://github.com/tmk/tmk_keyboard/issues/60
@@ -138,6 +210,13 @@ bool process_tapping(keyrecord_t *keyp)
                     // set interrupted flag when other key preesed during tapping
                     if (event.pressed) {
                         tapping_key.tap.interrupted = true;
+                        // the outcome is known, no need to wait out the term
+                        if (TAPPING_KEY_HOLD_ON_OTHER) {
+                            debug("Tapping: End. No tap. Other key pressed\n");
+                            process_record(&tapping_key);
+                            tapping_key = (keyrecord_t){};
+                            debug_tapping_key();
+                        }
                     }
                     // enqueue
                     return false;
@@ -166,7 +245,7 @@ bool process_tapping(keyrecord_t *keyp)
                     } else {
                         debug("Tapping: Start while last tap(1).\n");
                     }
-                    tapping_key = *keyp;
+                    tapping_key_press(keyp);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -210,7 +289,7 @@ bool process_tapping(keyrecord_t *keyp)
                     } else {
                         debug("Tapping: Start while last timeout tap(1).\n");
                     }
-                    tapping_key = *keyp;
+                    tapping_key_press(keyp);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -234,18 +313,18 @@ bool process_tapping(keyrecord_t *keyp)
                         if (keyp->tap.count < 15) keyp->tap.count += 1;
                         debug("Tapping: Tap press("); debug_dec(keyp->tap.count); debug(")\n");
                         process_record(keyp);
-                        tapping_key = *keyp;
+                        tapping_key_press(keyp);
                         debug_tapping_key();
                         return true;
                     } else {
                         // FIX: start new tap again
-                        tapping_key = *keyp;
+                        tapping_key_press(keyp);
                         return true;
                     }
                 } else if (is_tap_key(event.key)) {
                     // Sequential tap can be interfered with other tap key.
                     debug("Tapping: Start with interfering other tap.\n");
-                    tapping_key = *keyp;
+                    tapping_key_press(keyp);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -275,7 +354,7 @@ bool process_tapping(keyrecord_t *keyp)
     else {
         if (event.pressed && is_tap_key(event.key)) {
             debug("Tapping: Start(Press tap key).\n");
-            tapping_key = *keyp;
+            tapping_key_press(keyp);
             waiting_buffer_scan_tap();
             debug_tapping_key();
             return true;
@@ -296,41 +375,67 @@ bool waiting_buffer_enq(keyrecord_t record)
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (!waiting_ring_push(&waiting_buffer, &record)) {
         debug("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
-    waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    keypos_t key = record.event.key;
+    if (record.event.pressed) waiting_pressed_count++;
+    if (WAITING_KEY_INDEXED(key)) {
+        waiting_keys[key.row][key.col] += WAITING_KEY_STEP(record.event.pressed);
+    }
 
     debug("waiting_buffer_enq: "); debug_waiting_buffer();
     return true;
 }
 
+/* drop the oldest event */
+void waiting_buffer_deq(void)
+{
+    keyrecord_t record;
+    if (!waiting_ring_pop(&waiting_buffer, &record)) return;
+
+    keypos_t key = record.event.key;
+    if (record.event.pressed) waiting_pressed_count--;
+    if (WAITING_KEY_INDEXED(key)) {
+        waiting_keys[key.row][key.col] -= WAITING_KEY_STEP(record.event.pressed);
+    }
+}
+
 void waiting_buffer_clear(void)
 {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    while (waiting_ring_count(&waiting_buffer)) {
+        waiting_buffer_deq();
+    }
 }
 
-bool waiting_buffer_typed(keyevent_t event)
+/* End tapping as its timeout would and process what the buffer allows */
+void waiting_buffer_settle(void)
 {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed !=  waiting_buffer[i].event.pressed) {
-            return true;
-        }
+    if (IS_TAPPING_PRESSED() && tapping_key.tap.count == 0) {
+        debug("Tapping: End. Buffer full. Not tap(0).\n");
+        process_record(&tapping_key);
+    }
+    tapping_key = (keyrecord_t){};
+    debug_tapping_key();
+
+    for (keyrecord_t *waiting; (waiting = waiting_ring_peek(&waiting_buffer, 0)); waiting_buffer_deq()) {
+        if (!process_tapping(waiting)) break;
     }
-    return false;
+}
+
+bool waiting_buffer_typed(keyevent_t event)
+{
+    if (!WAITING_KEY_INDEXED(event.key)) return false;
+    uint8_t index = waiting_keys[event.key.row][event.key.col];
+    return event.pressed ? WAITING_KEY_RELEASES(index) : WAITING_KEY_PRESSES(index);
 }
 
 __attribute__((unused))
 bool waiting_buffer_has_anykey_pressed(void)
 {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
-    }
-    return false;
+    return waiting_pressed_count;
 }
 
 /* scan buffer for tapping */
@@ -340,13 +445,16 @@ void waiting_buffer_scan_tap(void)
     if (tapping_key.tap.count > 0) return;
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
+    // no release of the tapping key waiting
+    if (!waiting_buffer_typed(tapping_key.event)) return;
 
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (IS_TAPPING_KEY(waiting_buffer[i].event.key) &&
-                !waiting_buffer[i].event.pressed &&
-                WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
+    keyrecord_t *waiting;
+    for (uint8_t i = 0; (waiting = waiting_ring_peek(&waiting_buffer, i)); i++) {
+        if (IS_TAPPING_KEY(waiting->event.key) &&
+                !waiting->event.pressed &&
+                WITHIN_TAPPING_TERM(waiting->event)) {
             tapping_key.tap.count = 1;
-            waiting_buffer[i].tap.count = 1;
+            waiting->tap.count = 1;
             process_record(&tapping_key);
 
             debug("waiting_buffer_scan_tap: found at ["); debug_dec(i); debug("]\n");
@@ -368,8 +476,9 @@ static void debug_tapping_key(void)
 static void debug_waiting_buffer(void)
 {
     debug("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        debug("["); debug_dec(i); debug("]="); debug_record(waiting_buffer[i]); debug(" ");
+    keyrecord_t *waiting;
+    for (uint8_t i = 0; (waiting = waiting_ring_peek(&waiting_buffer, i)); i++) {
+        debug("["); debug_dec(i); debug("]="); debug_record(*waiting); debug(" ");
     }
     debug("}\n");
 }
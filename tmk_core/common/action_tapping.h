@@ -29,11 +29,39 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define TAPPING_TOGGLE  5
 #endif
 
+/* key events held while a tap key is undecided, a power of two up to 16 */
+#ifndef WAITING_BUFFER_SIZE
 #define WAITING_BUFFER_SIZE 8
+#endif
 
 
 #ifndef NO_ACTION_TAPPING
 void action_tapping_process(keyrecord_t record);
+
+/* Per key tap/hold settings
+ *
+ * TAPPING_TERM_PER_KEY             term instead of TAPPING_TERM
+ * PERMISSIVE_HOLD                  another key typed while a tap key is held
+ *                                  decides it as hold on that key's release
+ * PERMISSIVE_HOLD_PER_KEY          same, for keys with permissive_hold set
+ * HOLD_ON_OTHER_KEY_PRESS          another key pressed while a tap key is held
+ *                                  decides it as hold right away
+ * HOLD_ON_OTHER_KEY_PRESS_PER_KEY  same, for keys with hold_on_other_key_press
+ *                                  set
+ *
+ * get_tapping_settings() is called once when a tap key is pressed, with the
+ * defaults filled in, and the settings stay with it while it is the tapping
+ * key, whatever layers change meanwhile.
+ * quantum.c implements it with _kb() and _user() hooks taking the keycode,
+ * e.g. get_tapping_term_user().
+ */
+typedef struct {
+    uint16_t term;
+    bool permissive_hold;
+    bool hold_on_other_key_press;
+} tapping_settings_t;
+
+void get_tapping_settings(keypos_t key, tapping_settings_t *settings);
 #endif
 
 #endif
@@ -50,6 +50,29 @@ static int8_t cb_count = 0;
 //report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
 
+/* One bit per keycode in the 6KRO keys array, add_key/del_key check it before
+ * searching the array so repeated and stray calls cost nothing. */
+static uint8_t key_bits[32];
+#define KEY_BIT_IS_SET(code)    (key_bits[(code)>>3] & (1<<((code)&7)))
+#define KEY_BIT_SET(code)       (key_bits[(code)>>3] |= (1<<((code)&7)))
+#define KEY_BIT_CLEAR(code)     (key_bits[(code)>>3] &= ~(1<<((code)&7)))
+
+/* set whenever keyboard_report changes, send_keyboard_report() skips the host otherwise */
+static bool keyboard_report_dirty = true;
+
+#ifdef NKRO_ENABLE
+/* layout keyboard_report holds, its keys are dropped when the protocol changes */
+static bool keyboard_report_nkro = false;
+
+static void check_report_layout(bool nkro)
+{
+    if (keyboard_report_nkro != nkro) {
+        clear_keys();
+        keyboard_report_nkro = nkro;
+    }
+}
+#endif
+
 #ifndef NO_ACTION_ONESHOT
 static int8_t oneshot_mods = 0;
 static int8_t oneshot_locked_mods = 0;
@@ -118,9 +141,7 @@ bool is_oneshot_layer_active(void)
 #endif
 
 void send_keyboard_report(void) {
-    keyboard_report->mods  = real_mods;
-    keyboard_report->mods |= weak_mods;
-    keyboard_report->mods |= macro_mods;
+    uint8_t mods = real_mods | weak_mods | macro_mods;
 #ifndef NO_ACTION_ONESHOT
     if (oneshot_mods) {
 #if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
@@ -129,13 +150,19 @@ void send_keyboard_report(void) {
             clear_oneshot_mods();
         }
 #endif
-        keyboard_report->mods |= oneshot_mods;
+        mods |= oneshot_mods;
         if (has_anykey()) {
             clear_oneshot_mods();
         }
     }
 
 #endif
+    if (keyboard_report->mods != mods) {
+        keyboard_report->mods = mods;
+        keyboard_report_dirty = true;
+    }
+    if (!keyboard_report_dirty) return;
+    keyboard_report_dirty = false;
     host_keyboard_send(keyboard_report);
 }
 
@@ -144,9 +171,11 @@ void add_key(uint8_t key)
 {
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
+        check_report_layout(true);
         add_key_bit(key);
         return;
     }
+    check_report_layout(false);
 #endif
     add_key_byte(key);
 }
@@ -155,9 +184,11 @@ void del_key(uint8_t key)
 {
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
+        check_report_layout(true);
         del_key_bit(key);
         return;
     }
+    check_report_layout(false);
 #endif
     del_key_byte(key);
 }
@@ -166,7 +197,13 @@ void clear_keys(void)
 {
     // not clear mods
     for (int8_t i = 1; i < KEYBOARD_REPORT_SIZE; i++) {
-        keyboard_report->raw[i] = 0;
+        if (keyboard_report->raw[i]) {
+            keyboard_report->raw[i] = 0;
+            keyboard_report_dirty = true;
+        }
+    }
+    for (uint8_t i = 0; i < sizeof(key_bits); i++) {
+        key_bits[i] = 0;
     }
 }
 
@@ -261,6 +298,7 @@ uint8_t get_first_key(void)
 /* local functions */
 static inline void add_key_byte(uint8_t code)
 {
+    if (KEY_BIT_IS_SET(code)) return;
 #ifdef USB_6KRO_ENABLE
     int8_t i = cb_head;
     int8_t empty = -1;
@@ -279,6 +317,7 @@ static inline void add_key_byte(uint8_t code)
                 // buffer is full
                 if (empty == -1) {
                     // pop head when has no empty space
+                    KEY_BIT_CLEAR(keyboard_report->keys[cb_head]);
                     cb_head = RO_INC(cb_head);
                     cb_count--;
                 }
@@ -306,27 +345,26 @@ static inline void add_key_byte(uint8_t code)
     keyboard_report->keys[cb_tail] = code;
     cb_tail = RO_INC(cb_tail);
     cb_count++;
+    KEY_BIT_SET(code);
+    keyboard_report_dirty = true;
 #else
-    int8_t i = 0;
-    int8_t empty = -1;
-    for (; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == code) {
+    // not in the report yet, take the first empty slot
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report->keys[i] == 0) {
+            keyboard_report->keys[i] = code;
+            KEY_BIT_SET(code);
+            keyboard_report_dirty = true;
             break;
         }
-        if (empty == -1 && keyboard_report->keys[i] == 0) {
-            empty = i;
-        }
-    }
-    if (i == KEYBOARD_REPORT_KEYS) {
-        if (empty != -1) {
-            keyboard_report->keys[empty] = code;
-        }
     }
 #endif
 }
 
 static inline void del_key_byte(uint8_t code)
 {
+    if (!KEY_BIT_IS_SET(code)) return;
+    KEY_BIT_CLEAR(code);
+    keyboard_report_dirty = true;
 #ifdef USB_6KRO_ENABLE
     uint8_t i = cb_head;
     if (cb_count) {
@@ -356,6 +394,7 @@ static inline void del_key_byte(uint8_t code)
     for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
         if (keyboard_report->keys[i] == code) {
             keyboard_report->keys[i] = 0;
+            break;
         }
     }
 #endif
@@ -366,6 +405,7 @@ static inline void add_key_bit(uint8_t code)
 {
     if ((code>>3) < KEYBOARD_REPORT_BITS) {
         keyboard_report->nkro.bits[code>>3] |= 1<<(code&7);
+        keyboard_report_dirty = true;
     } else {
         dprintf("add_key_bit: can't add: %02X\n", code);
     }
@@ -375,6 +415,7 @@ static inline void del_key_bit(uint8_t code)
 {
     if ((code>>3) < KEYBOARD_REPORT_BITS) {
         keyboard_report->nkro.bits[code>>3] &= ~(1<<(code&7));
+        keyboard_report_dirty = true;
     } else {
         dprintf("del_key_bit: can't del: %02X\n", code);
     }
@@ -0,0 +1,163 @@
+#include <string.h>
+#include <stdbool.h>
+#include "bench.h"
+#include "timer.h"
+#include "print.h"
+
+#if defined(PROTOCOL_CHIBIOS)
+#   include "ch.h"
+#   include "hal.h"
+#   if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+#       define BENCH_USE_DWT
+#   endif
+#elif defined(__AVR__)
+#   include <avr/io.h>
+#   include <util/atomic.h>
+#   include "avr/timer_avr.h"
+#endif
+
+static bench_stats_t stats[BENCH_STAGE_COUNT];
+static uint32_t scan_start;
+static bool scan_reported = true;
+/* set from USB interrupts on drivers that start transfers there */
+static volatile bool scan_transmitted = true;
+
+#ifndef NO_PRINT
+static const char *const stage_names[BENCH_STAGE_COUNT] = {
+    [BENCH_MATRIX_SCAN]            = "matrix_scan",
+    [BENCH_ACTION_EXEC]            = "action_exec",
+    [BENCH_PROCESS_RECORD_QUANTUM] = "process_record_quantum",
+    [BENCH_HOST_KEYBOARD_SEND]     = "host_keyboard_send",
+    [BENCH_SCAN_TO_REPORT]         = "scan_to_report",
+    [BENCH_SCAN_TO_USB_TX]         = "scan_to_usb_tx",
+};
+#endif
+
+void bench_init(void)
+{
+#ifdef BENCH_USE_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    bench_clear();
+}
+
+uint32_t bench_now(void)
+{
+#if defined(BENCH_USE_DWT)
+    return DWT->CYCCNT;
+#elif defined(__AVR__)
+    /* Timer0 counts TIMER_RAW_TOP+1 ticks per millisecond in CTC mode */
+    uint32_t ms;
+    uint8_t raw;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms = timer_count;
+        raw = TIMER_RAW;
+#   ifdef TIFR0
+        if (TIFR0 & (1<<OCF0A)) {
+#   else
+        if (TIFR & (1<<OCF0)) {
+#   endif
+            /* compare match not serviced yet, the counter has wrapped */
+            raw = TIMER_RAW;
+            ms++;
+        }
+    }
+    return ms * (TIMER_RAW_TOP + 1) + raw;
+#else
+    return timer_read32();
+#endif
+}
+
+static uint8_t bucket_of(uint32_t duration)
+{
+    uint8_t bucket = 0;
+    while (duration && bucket < BENCH_HISTOGRAM_BUCKETS - 1) {
+        duration >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void bench_record(bench_stage_t stage, uint32_t start)
+{
+    uint32_t duration = bench_now() - start;
+    bench_stats_t *s = &stats[stage];
+
+    if (s->count == 0 || duration < s->min) s->min = duration;
+    if (duration > s->max) s->max = duration;
+    if (s->sum + duration < s->sum || s->count == UINT32_MAX) {
+        /* halve both instead of overflowing, the average stays the same */
+        s->sum >>= 1;
+        s->count >>= 1;
+    }
+    s->sum += duration;
+    s->count++;
+    uint8_t bucket = bucket_of(duration);
+    if (s->histogram[bucket] < UINT16_MAX) s->histogram[bucket]++;
+}
+
+void bench_scan_begin(void)
+{
+    scan_start = bench_now();
+    scan_reported = false;
+    scan_transmitted = false;
+}
+
+void bench_report_sent(void)
+{
+    if (scan_reported) return;
+    scan_reported = true;
+    bench_record(BENCH_SCAN_TO_REPORT, scan_start);
+}
+
+void bench_usb_transmit(void)
+{
+    if (scan_transmitted) return;
+    scan_transmitted = true;
+    bench_record(BENCH_SCAN_TO_USB_TX, scan_start);
+}
+
+const bench_stats_t *bench_get_stats(bench_stage_t stage)
+{
+    return &stats[stage];
+}
+
+void bench_clear(void)
+{
+    memset(stats, 0, sizeof(stats));
+    scan_reported = true;
+    scan_transmitted = true;
+}
+
+void bench_print(void)
+{
+#ifndef NO_PRINT
+#if defined(BENCH_USE_DWT)
+    print("\n\t- Latency (cycles) -\n");
+#elif defined(__AVR__)
+    print("\n\t- Latency (timer0 ticks) -\n");
+#else
+    print("\n\t- Latency (ms) -\n");
+#endif
+    for (uint8_t i = 0; i < BENCH_STAGE_COUNT; i++) {
+        const bench_stats_t *s = &stats[i];
+        xprintf("%s: n=%lu", stage_names[i], (unsigned long)s->count);
+        if (!s->count) {
+            print("\n");
+            continue;
+        }
+        xprintf(" min=%lu avg=%lu max=%lu\n",
+                (unsigned long)s->min, (unsigned long)(s->sum / s->count), (unsigned long)s->max);
+        for (uint8_t b = 0; b < BENCH_HISTOGRAM_BUCKETS; b++) {
+            if (!s->histogram[b]) continue;
+            if (b == BENCH_HISTOGRAM_BUCKETS - 1) {
+                xprintf("  >=%lu: %u\n", 1UL << (b - 1), s->histogram[b]);
+            } else {
+                xprintf("  <%lu: %u\n", 1UL << b, s->histogram[b]);
+            }
+        }
+    }
+#endif
+}
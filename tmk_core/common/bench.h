@@ -0,0 +1,69 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+/* Latency benchmark
+ *
+ * Times each stage of the scan-to-report path and keeps min/avg/max and a
+ * log2 histogram per stage. Durations are in bench clock units: CPU cycles
+ * from the DWT counter on ChibiOS Cortex-M3 and up, Timer0 ticks on AVR
+ * (TIMER_RAW_FREQ per second) and milliseconds elsewhere.
+ */
+
+typedef enum {
+    BENCH_MATRIX_SCAN,
+    BENCH_ACTION_EXEC,
+    BENCH_PROCESS_RECORD_QUANTUM,
+    BENCH_HOST_KEYBOARD_SEND,
+    /* from the start of matrix_scan() to the first report of that scan */
+    BENCH_SCAN_TO_REPORT,
+    /* from the start of matrix_scan() to the USB transfer of that report,
+     * only recorded by drivers calling bench_usb_transmit() */
+    BENCH_SCAN_TO_USB_TX,
+    BENCH_STAGE_COUNT
+} bench_stage_t;
+
+/* bucket n counts durations of less than 2^n units, the last one the rest */
+#ifndef BENCH_HISTOGRAM_BUCKETS
+#define BENCH_HISTOGRAM_BUCKETS 16
+#endif
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t count;
+    uint16_t histogram[BENCH_HISTOGRAM_BUCKETS];
+} bench_stats_t;
+
+#ifdef LATENCY_BENCH_ENABLE
+
+void bench_init(void);
+uint32_t bench_now(void);
+void bench_record(bench_stage_t stage, uint32_t start);
+void bench_scan_begin(void);
+void bench_report_sent(void);
+void bench_usb_transmit(void);
+const bench_stats_t *bench_get_stats(bench_stage_t stage);
+void bench_clear(void);
+void bench_print(void);
+
+#define BENCH_START(var)        uint32_t var = bench_now()
+#define BENCH_END(stage, var)   bench_record(stage, var)
+
+#else
+
+#define bench_init()
+#define bench_scan_begin()
+#define bench_report_sent()
+#define bench_usb_transmit()
+#define bench_clear()
+#define bench_print()
+
+#define BENCH_START(var)
+#define BENCH_END(stage, var)
+
+#endif
+
+#endif
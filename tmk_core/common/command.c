@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_util.h"
 #include "eeconfig.h"
 #include "sleep_led.h"
+#include "bench.h"
 #include "led.h"
 #include "command.h"
 #include "backlight.h"
@@ -170,6 +171,10 @@ static void command_common_help(void)
 #ifdef SLEEP_LED_ENABLE
 		STR(MAGIC_KEY_SLEEP_LED   ) ":	Sleep LED Test\n"
 #endif
+
+#ifdef LATENCY_BENCH_ENABLE
+		STR(MAGIC_KEY_BENCH       ) ":	Print and Reset Latency Benchmark\n"
+#endif
     );
 }
 
@@ -216,6 +221,9 @@ static void print_version(void)
 #ifdef KEYMAP_SECTION_ENABLE
 	    " KEYMAP_SECTION"
 #endif
+#ifdef LATENCY_BENCH_ENABLE
+	    " LATENCY_BENCH"
+#endif
 
 	    " " STR(BOOTLOADER_SIZE) "\n");
 
@@ -322,6 +330,15 @@ static bool command_common(uint8_t code)
             break;
 #endif
 
+#ifdef LATENCY_BENCH_ENABLE
+
+		// dump latency statistics and start over
+        case MAGIC_KC(MAGIC_KEY_BENCH):
+            bench_print();
+            bench_clear();
+            break;
+#endif
+
 #ifdef BOOTMAGIC_ENABLE
 
 		// print stored eeprom config
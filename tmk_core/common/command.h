@@ -146,6 +146,10 @@ bool command_proc(uint8_t code);
 #define MAGIC_KEY_NKRO           N
 #endif
 
+#ifndef MAGIC_KEY_BENCH
+#define MAGIC_KEY_BENCH          B
+#endif
+
 #ifndef MAGIC_KEY_SLEEP_LED
 #define MAGIC_KEY_SLEEP_LED      Z
 
@@ -0,0 +1,75 @@
+#include "deadline.h"
+#include "timer.h"
+
+/* The set of clients is fixed and small, so a slot per client with the
+ * earliest one cached beats a heap: setting or cancelling is a short scan,
+ * and the per-loop checks only compare against the cached minimum.
+ */
+static uint32_t deadlines[DEADLINE_COUNT];
+static uint8_t pending = 0;
+static uint32_t next_deadline = 0;
+
+#define DEADLINE_BIT(id)    ((uint8_t)1 << (id))
+
+/* has now passed time, wrap safe */
+static inline bool time_reached(uint32_t time, uint32_t now)
+{
+    return (int32_t)(now - time) >= 0;
+}
+
+static void update_next(void)
+{
+    bool first = true;
+    uint32_t now = timer_read32();
+    for (uint8_t i = 0; i < DEADLINE_COUNT; i++) {
+        if (!(pending & DEADLINE_BIT(i))) continue;
+        if (first || (int32_t)(deadlines[i] - now) < (int32_t)(next_deadline - now)) {
+            next_deadline = deadlines[i];
+            first = false;
+        }
+    }
+}
+
+void deadline_set(deadline_id_t id, uint32_t time)
+{
+    deadlines[id] = time;
+    pending |= DEADLINE_BIT(id);
+    update_next();
+}
+
+void deadline_set_in(deadline_id_t id, uint32_t ms)
+{
+    deadline_set(id, timer_read32() + ms);
+}
+
+void deadline_cancel(deadline_id_t id)
+{
+    if (!(pending & DEADLINE_BIT(id))) return;
+    pending &= ~DEADLINE_BIT(id);
+    update_next();
+}
+
+bool deadline_pending(deadline_id_t id)
+{
+    return pending & DEADLINE_BIT(id);
+}
+
+bool deadline_due(deadline_id_t id)
+{
+    return (pending & DEADLINE_BIT(id)) && time_reached(deadlines[id], timer_read32());
+}
+
+bool deadline_any_due(void)
+{
+    return pending && time_reached(next_deadline, timer_read32());
+}
+
+bool deadline_any_pending(void)
+{
+    return pending;
+}
+
+uint32_t deadline_next(void)
+{
+    return next_deadline;
+}
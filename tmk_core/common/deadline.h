@@ -0,0 +1,40 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Deadline scheduler
+ *
+ * Subsystems that wait on a timeout register the time they next need to run
+ * instead of polling timer_elapsed() on every loop. Their task functions
+ * return early until deadline_due(), and the main loop can tell from
+ * deadline_next() how long nothing has to happen.
+ *
+ * Times are timer_read32() milliseconds. A deadline stays due until it is
+ * set again or cancelled.
+ */
+
+typedef enum {
+    DEADLINE_TAPPING,
+    DEADLINE_MOUSEKEY,
+    DEADLINE_TAP_DANCE,
+    DEADLINE_LEADER,
+    DEADLINE_RGBLIGHT,
+    DEADLINE_MACRO,
+    DEADLINE_COUNT
+} deadline_id_t;
+
+void deadline_set(deadline_id_t id, uint32_t time);
+void deadline_set_in(deadline_id_t id, uint32_t ms);
+void deadline_cancel(deadline_id_t id);
+bool deadline_pending(deadline_id_t id);
+bool deadline_due(deadline_id_t id);
+/* true if any deadline is due */
+bool deadline_any_due(void);
+/* true if any deadline is set */
+bool deadline_any_pending(void);
+/* earliest pending deadline, only valid when deadline_any_pending() */
+uint32_t deadline_next(void);
+
+#endif
@@ -16,19 +16,158 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 //#include <avr/interrupt.h>
 #include "keycode.h"
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "bench.h"
+#ifdef NKRO_ENABLE
+#   include "keycode_config.h"
+#endif
 
 static host_driver_t *driver;
+static report_keyboard_t last_keyboard_report = {{0}};
 static uint16_t last_system_report = 0;
 static uint16_t last_consumer_report = 0;
 
+#ifdef KEYBOARD_REPORT_QUEUE
+/* Keyboard report queue
+ *
+ * host_keyboard_send() queues the report and returns. The driver gets one
+ * report at a time and calls host_keyboard_sent() once the endpoint has taken
+ * it, normally from its IN-complete callback, so the scan loop never waits on
+ * USB. A queued report that only sits between two others is replaced by the
+ * newer one when dropping it loses no press: it repeats a neighbour, or it
+ * and the newer report only release keys.
+ */
+#if !defined(PROTOCOL_CHIBIOS) && !defined(PROTOCOL_LUFA) && !defined(PLATFORM_TEST)
+#   error "KEYBOARD_REPORT_QUEUE needs a driver that calls host_keyboard_sent()"
+#endif
+
+#ifndef KEYBOARD_REPORT_QUEUE_SIZE
+#   define KEYBOARD_REPORT_QUEUE_SIZE 8
+#endif
+
+#if defined(PROTOCOL_CHIBIOS)
+#   include "ch.h"
+#   define REPORT_QUEUE_LOCK()      syssts_t report_queue_sts = chSysGetStatusAndLockX()
+#   define REPORT_QUEUE_UNLOCK()    chSysRestoreStatusX(report_queue_sts)
+#elif defined(__AVR__)
+#   include <avr/interrupt.h>
+#   define REPORT_QUEUE_LOCK()      uint8_t report_queue_sreg = SREG; cli()
+#   define REPORT_QUEUE_UNLOCK()    SREG = report_queue_sreg
+#else
+#   define REPORT_QUEUE_LOCK()
+#   define REPORT_QUEUE_UNLOCK()
+#endif
+
+#define REPORT_QUEUE_AT(i)  report_queue[(report_queue_head + (i)) % KEYBOARD_REPORT_QUEUE_SIZE]
+
+static report_keyboard_t report_queue[KEYBOARD_REPORT_QUEUE_SIZE];
+static uint8_t report_queue_head = 0;
+static uint8_t report_queue_count = 0;
+/* last report given to the driver, it reads from here until it is sent */
+static report_keyboard_t report_last;
+static bool report_busy = false;
+static bool report_starting = false;
+
+/* every key and modifier of b is also in a */
+static bool report_contains(const report_keyboard_t *a, const report_keyboard_t *b)
+{
+    if (b->mods & ~a->mods) return false;
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if (b->nkro.bits[i] & ~a->nkro.bits[i]) return false;
+        }
+        return true;
+    }
+#endif
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (!b->keys[i]) continue;
+        uint8_t j = 0;
+        while (j < KEYBOARD_REPORT_KEYS && a->keys[j] != b->keys[i]) j++;
+        if (j == KEYBOARD_REPORT_KEYS) return false;
+    }
+    return true;
+}
+
+static bool report_is_redundant(const report_keyboard_t *prev,
+                                const report_keyboard_t *mid,
+                                const report_keyboard_t *next)
+{
+    if (!memcmp(prev, mid, sizeof(*mid)) || !memcmp(mid, next, sizeof(*mid))) return true;
+    return report_contains(prev, mid) && report_contains(mid, next);
+}
+
+static void report_queue_push(const report_keyboard_t *report)
+{
+    if (!report_queue_count && report_busy && !memcmp(&report_last, report, sizeof(*report))) {
+        // repeats the report on its way out
+        return;
+    }
+    if (report_queue_count) {
+        report_keyboard_t *tail = &REPORT_QUEUE_AT(report_queue_count - 1);
+        const report_keyboard_t *prev = (report_queue_count > 1 ?
+                &REPORT_QUEUE_AT(report_queue_count - 2) : &report_last);
+        if (report_is_redundant(prev, tail, report)) {
+            *tail = *report;
+            return;
+        }
+    }
+    if (report_queue_count == KEYBOARD_REPORT_QUEUE_SIZE) {
+        // the host stopped polling, keep the newest state
+        dprint("keyboard report queue full\n");
+        REPORT_QUEUE_AT(report_queue_count - 1) = *report;
+        return;
+    }
+    REPORT_QUEUE_AT(report_queue_count) = *report;
+    report_queue_count++;
+}
+
+static void report_queue_start(void)
+{
+    // a driver that drops the report calls host_keyboard_sent() from in here
+    if (report_starting) return;
+    report_starting = true;
+    while (driver && !report_busy && report_queue_count) {
+        report_last = report_queue[report_queue_head];
+        report_queue_head = (report_queue_head + 1) % KEYBOARD_REPORT_QUEUE_SIZE;
+        report_queue_count--;
+        report_busy = true;
+        (*driver->send_keyboard)(&report_last);
+    }
+    report_starting = false;
+}
+
+void host_keyboard_sent(void)
+{
+    REPORT_QUEUE_LOCK();
+    report_busy = false;
+    report_queue_start();
+    REPORT_QUEUE_UNLOCK();
+}
+
+uint8_t host_keyboard_queued(void)
+{
+    return report_queue_count + report_busy;
+}
+#endif
+
 
 void host_set_driver(host_driver_t *d)
 {
+    /* a new host starts with nothing pressed, whatever the old one was sent */
+    memset(&last_keyboard_report, 0, sizeof(last_keyboard_report));
+#ifdef KEYBOARD_REPORT_QUEUE
+    REPORT_QUEUE_LOCK();
+    report_queue_count = 0;
+    report_busy = false;
+    memset(&report_last, 0, sizeof(report_last));
+    REPORT_QUEUE_UNLOCK();
+#endif
     driver = d;
 }
 
@@ -46,7 +185,22 @@ uint8_t host_keyboard_leds(void)
 void host_keyboard_send(report_keyboard_t *report)
 {
     if (!driver) return;
+    if (!memcmp(report, &last_keyboard_report, sizeof(*report))) return;
+    last_keyboard_report = *report;
+
+    BENCH_START(send_start);
+#ifdef KEYBOARD_REPORT_QUEUE
+    {
+        REPORT_QUEUE_LOCK();
+        report_queue_push(report);
+        report_queue_start();
+        REPORT_QUEUE_UNLOCK();
+    }
+#else
     (*driver->send_keyboard)(report);
+#endif
+    BENCH_END(BENCH_HOST_KEYBOARD_SEND, send_start);
+    bench_report_sent();
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -46,6 +46,13 @@ void host_consumer_send(uint16_t data);
 uint16_t host_last_system_report(void);
 uint16_t host_last_consumer_report(void);
 
+#ifdef KEYBOARD_REPORT_QUEUE
+/* for the driver: the endpoint took the report, send_keyboard() may be called again */
+void host_keyboard_sent(void);
+/* reports not yet taken by the endpoint, including the one being sent */
+uint8_t host_keyboard_queued(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "eeconfig.h"
 #include "backlight.h"
 #include "action_layer.h"
+#include "deadline.h"
+#include "bench.h"
+#include "debounce.h"
+#ifdef SCAN_THREAD
+#   include "spsc_ring.h"
+#endif
 #ifdef BOOTMAGIC_ENABLE
 #   include "bootmagic.h"
 #else
@@ -86,6 +92,7 @@ void keyboard_setup(void) {
 
 void keyboard_init(void) {
     timer_init();
+    bench_init();
     matrix_init();
 #ifdef PS2_MOUSE_ENABLE
     ps2_mouse_init();
@@ -112,22 +119,93 @@ void keyboard_init(void) {
 #endif
 }
 
-/*
- * Do keyboard routine jobs: scan mantrix, light LEDs, ...
- * This is repeatedly called as fast as possible.
+/* Maximum number of matrix changes dispatched per keyboard_task() call.
+ * With the default of 1 each changed key costs a full matrix scan, so a chord
+ * of N keys needs N scans to reach action_exec. Larger values queue up to that
+ * many changes from a single scan and dispatch them in the same call.
  */
-void keyboard_task(void)
+#ifndef QMK_KEYS_PER_SCAN
+#   define QMK_KEYS_PER_SCAN 1
+#endif
+
+#ifdef MATRIX_IDLE_SLEEP
+/* Idle sleep
+ *
+ * Once nothing is pressed keyboard_task() arms the matrix wakeup and stops
+ * scanning; each call then only checks matrix_wakeup_pending() and whether a
+ * deadline came due. The main loop puts the CPU to sleep between calls while
+ * keyboard_is_idle() is true.
+ */
+static bool keyboard_sleeping = false;
+
+/* Matrices without wakeup support are scanned to look for a press */
+__attribute__ ((weak))
+void matrix_wakeup_arm(void) {}
+
+__attribute__ ((weak))
+void matrix_wakeup_disarm(void) {}
+
+__attribute__ ((weak))
+bool matrix_wakeup_pending(void)
+{
+    matrix_scan();
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        if (matrix_get_row(r)) return true;
+    }
+    return false;
+}
+
+__attribute__ ((weak))
+bool keyboard_idle_quantum(void)
 {
-    static matrix_row_t matrix_prev[MATRIX_ROWS];
+    return true;
+}
+
+/* Matrices without the quantum debounce algorithms have nothing settling */
+__attribute__ ((weak))
+bool debounce_active(void)
+{
+    return false;
+}
+
+/* A press still being debounced isn't in matrix_state yet, and its edge has
+ * already passed, so the wakeup would never see it */
+static bool keyboard_can_sleep(const matrix_row_t matrix_state[])
+{
+    if (debounce_active()) return false;
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        if (matrix_state[r]) return false;
+    }
+    return keyboard_idle_quantum();
+}
+#endif
+
+bool keyboard_is_idle(void)
+{
+#ifdef MATRIX_IDLE_SLEEP
+    return keyboard_sleeping;
+#else
+    return false;
+#endif
+}
+
+static matrix_row_t matrix_prev[MATRIX_ROWS];
 #ifdef MATRIX_HAS_GHOST
-    static matrix_row_t matrix_ghost[MATRIX_ROWS];
+static matrix_row_t matrix_ghost[MATRIX_ROWS];
 #endif
-    static uint8_t led_status = 0;
+
+/* Collect up to max changes of the last matrix_scan() in row/col order.
+ * Changes past max stay out of matrix_prev and are found again next time.
+ */
+static uint8_t matrix_collect_events(keyevent_t events[], uint8_t max)
+{
     matrix_row_t matrix_row = 0;
     matrix_row_t matrix_change = 0;
+    uint8_t events_count = 0;
 
-    matrix_scan();
-    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+    /* all changes of one scan share its timestamp */
+    const uint16_t scan_time = timer_read() | 1; /* time should not be 0 */
+    for (uint8_t r = 0; r < MATRIX_ROWS && events_count < max; r++) {
         matrix_row = matrix_get_row(r);
         matrix_change = matrix_row ^ matrix_prev[r];
         if (matrix_change) {
@@ -148,23 +226,127 @@ void keyboard_task(void)
             if (debug_matrix) matrix_print();
             for (uint8_t c = 0; c < MATRIX_COLS; c++) {
                 if (matrix_change & ((matrix_row_t)1<<c)) {
-                    action_exec((keyevent_t){
+                    events[events_count++] = (keyevent_t){
                         .key = (keypos_t){ .row = r, .col = c },
                         .pressed = (matrix_row & ((matrix_row_t)1<<c)),
-                        .time = (timer_read() | 1) /* time should not be 0 */
-                    });
-                    // record a processed key
+                        .time = scan_time
+                    };
+                    // record a queued key
                     matrix_prev[r] ^= ((matrix_row_t)1<<c);
-                    // process a key per task call
-                    goto MATRIX_LOOP_END;
+                    if (events_count == max) {
+                        return events_count;
+                    }
                 }
             }
         }
     }
-    // call with pseudo tick event when no real key event.
-    action_exec(TICK);
+    return events_count;
+}
+
+#ifdef SCAN_THREAD
+/* Scan thread
+ *
+ * keyboard_scan() scans and debounces the matrix and queues the changes;
+ * keyboard_task() takes them from the ring and does everything else. The
+ * platform runs keyboard_scan() in its own higher priority thread, so slow
+ * work in keyboard_task(), lighting or a console flush, never holds up key
+ * detection. matrix_scan_quantum() work moves to keyboard_task_quantum() as
+ * it drives layers, lighting and the host.
+ */
+#   ifdef MATRIX_IDLE_SLEEP
+#       error "MATRIX_IDLE_SLEEP cannot be used with SCAN_THREAD"
+#   endif
+#   ifndef SCAN_THREAD_RING_SIZE
+#       define SCAN_THREAD_RING_SIZE 16
+#   endif
+SPSC_RING_DECLARE(keyevent_ring, keyevent_t, SCAN_THREAD_RING_SIZE)
+
+static keyevent_ring_t scan_events;
+
+bool keyboard_scan(void)
+{
+    keyevent_t events[SCAN_THREAD_RING_SIZE];
+
+    bench_scan_begin();
+    BENCH_START(scan_start);
+    matrix_scan();
+    BENCH_END(BENCH_MATRIX_SCAN, scan_start);
+    // a full ring holds back the rest until keyboard_task() catches up
+    uint8_t events_count = matrix_collect_events(events,
+            SCAN_THREAD_RING_SIZE - keyevent_ring_count(&scan_events));
+    for (uint8_t i = 0; i < events_count; i++) {
+        keyevent_ring_push(&scan_events, &events[i]);
+    }
+    return events_count;
+}
+
+__attribute__ ((weak))
+void keyboard_task_quantum(void) {}
+#endif
+
+/*
+ * Do keyboard routine jobs: scan mantrix, light LEDs, ...
+ * This is repeatedly called as fast as possible.
+ */
+void keyboard_task(void)
+{
+    static uint8_t led_status = 0;
+    /* changes found in this scan, in row/col order */
+    keyevent_t events[QMK_KEYS_PER_SCAN];
+    uint8_t events_count = 0;
+
+#ifdef NONBLOCKING_MACROS
+    // play the next macro step; key changes wait until playback has ended so
+    // they reach the host after the macro, as they did when it blocked
+    action_macro_task();
+    const bool macro_playing = action_macro_playing();
+#else
+    const bool macro_playing = false;
+#endif
+
+#ifdef SCAN_THREAD
+    while (!macro_playing && events_count < QMK_KEYS_PER_SCAN &&
+           keyevent_ring_pop(&scan_events, &events[events_count])) {
+        events_count++;
+    }
+    keyboard_task_quantum();
+#else
+#ifdef MATRIX_IDLE_SLEEP
+    if (keyboard_sleeping) {
+        if (!matrix_wakeup_pending() && !deadline_any_due() && keyboard_idle_quantum()) {
+            goto MATRIX_IDLE;
+        }
+        matrix_wakeup_disarm();
+        keyboard_sleeping = false;
+    }
+#endif
+
+    bench_scan_begin();
+    BENCH_START(scan_start);
+    matrix_scan();
+    BENCH_END(BENCH_MATRIX_SCAN, scan_start);
+    // the rest is left for the next task call
+    events_count = matrix_collect_events(events, macro_playing ? 0 : QMK_KEYS_PER_SCAN);
+#endif
+
+    // dispatch in scan order so the tapping state machine sees each key in sequence
+    for (uint8_t i = 0; i < events_count; i++) {
+        BENCH_START(exec_start);
+        action_exec(events[i]);
+        BENCH_END(BENCH_ACTION_EXEC, exec_start);
+    }
+    // call with pseudo tick event when no real key event and tapping has a decision due
+    if (!events_count && deadline_due(DEADLINE_TAPPING)) {
+        action_exec(TICK);
+    }
 
-MATRIX_LOOP_END:
+#ifdef MATRIX_IDLE_SLEEP
+    if (!events_count && keyboard_can_sleep(matrix_prev)) {
+        matrix_wakeup_arm();
+        keyboard_sleeping = true;
+    }
+MATRIX_IDLE:
+#endif
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
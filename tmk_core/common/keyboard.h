@@ -64,6 +64,16 @@ void keyboard_setup(void);
 void keyboard_init(void);
 /* it runs repeatedly in main loop */
 void keyboard_task(void);
+/* nothing to do until the next key press, see MATRIX_IDLE_SLEEP */
+bool keyboard_is_idle(void);
+/* vetoes idle sleep while quantum features wait on a timeout */
+bool keyboard_idle_quantum(void);
+#ifdef SCAN_THREAD
+/* scan thread half of keyboard_task(), true when it queued key changes */
+bool keyboard_scan(void);
+/* runs the matrix_scan_quantum() work from keyboard_task() */
+void keyboard_task_quantum(void);
+#endif
 /* it runs when host LED status is updated */
 void keyboard_set_leds(uint8_t leds);
 
@@ -62,6 +62,12 @@ void matrix_print(void);
 void matrix_power_up(void);
 void matrix_power_down(void);
 
+/* idle sleep (MATRIX_IDLE_SLEEP): make any key press visible on the input
+ * lines without scanning, and check for one */
+void matrix_wakeup_arm(void);
+void matrix_wakeup_disarm(void);
+bool matrix_wakeup_pending(void);
+
 /* executes code for Quantum */
 void matrix_init_quantum(void);
 void matrix_scan_quantum(void);
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "keycode.h"
 #include "host.h"
 #include "timer.h"
+#include "deadline.h"
 #include "print.h"
 #include "debug.h"
 #include "mousekey.h"
@@ -53,7 +54,6 @@ uint8_t mk_wheel_max_speed = MOUSEKEY_WHEEL_MAX_SPEED;
 uint8_t mk_wheel_time_to_max = MOUSEKEY_WHEEL_TIME_TO_MAX;
 
 
-static uint16_t last_timer = 0;
 
 
 static uint8_t move_unit(void)
@@ -96,7 +96,7 @@ static uint8_t wheel_unit(void)
 
 void mousekey_task(void)
 {
-    if (timer_elapsed(last_timer) < (mousekey_repeat ? mk_interval : mk_delay*10))
+    if (!deadline_due(DEADLINE_MOUSEKEY))
         return;
 
     if (mouse_report.x == 0 && mouse_report.y == 0 && mouse_report.v == 0 && mouse_report.h == 0)
@@ -172,7 +172,13 @@ void mousekey_send(void)
 {
     mousekey_debug();
     host_mouse_send(&mouse_report);
-    last_timer = timer_read();
+
+    // schedule the next repeat while anything moves
+    if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) {
+        deadline_set_in(DEADLINE_MOUSEKEY, mousekey_repeat ? mk_interval : mk_delay*10);
+    } else {
+        deadline_cancel(DEADLINE_MOUSEKEY);
+    }
 }
 
 void mousekey_clear(void)
@@ -180,6 +186,7 @@ void mousekey_clear(void)
     mouse_report = (report_mouse_t){};
     mousekey_repeat = 0;
     mousekey_accel = 0;
+    deadline_cancel(DEADLINE_MOUSEKEY);
 }
 
 static void mousekey_debug(void)
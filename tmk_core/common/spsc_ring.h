@@ -0,0 +1,73 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* Single producer, single consumer ring
+ *
+ * One side only pushes and the other only pops, so two threads or a thread
+ * and an interrupt can share a ring without a lock: head is written by the
+ * producer alone and tail by the consumer alone. Both are free running 8 bit
+ * counters, which every supported MCU loads and stores in one access.
+ *
+ *   SPSC_RING_DECLARE(name, type, size)
+ *
+ * defines name_t and static inline name_push(), name_pop(), name_peek(),
+ * name_count() and name_clear(). size must be a power of two up to 128.
+ * peek and clear belong to the consumer side.
+ */
+
+/* keep the compiler from moving item accesses across the index update */
+#define SPSC_RING_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+#define SPSC_RING_DECLARE(name, type, size)                                         \
+typedef char name##_size_check[((size) & ((size) - 1)) == 0 && (size) <= 128 ? 1 : -1]; \
+                                                                                    \
+typedef struct {                                                                    \
+    volatile uint8_t head;                                                          \
+    volatile uint8_t tail;                                                          \
+    type items[size];                                                               \
+} name##_t;                                                                         \
+                                                                                    \
+static inline uint8_t name##_count(const name##_t *ring)                            \
+{                                                                                   \
+    return (uint8_t)(ring->head - ring->tail);                                      \
+}                                                                                   \
+                                                                                    \
+static inline bool name##_push(name##_t *ring, const type *item)                    \
+{                                                                                   \
+    uint8_t head = ring->head;                                                      \
+    if ((uint8_t)(head - ring->tail) == (size)) return false;                       \
+    ring->items[head & ((size) - 1)] = *item;                                       \
+    SPSC_RING_BARRIER();                                                            \
+    ring->head = (uint8_t)(head + 1);                                               \
+    return true;                                                                    \
+}                                                                                   \
+                                                                                    \
+static inline bool name##_pop(name##_t *ring, type *item)                           \
+{                                                                                   \
+    uint8_t tail = ring->tail;                                                      \
+    if (ring->head == tail) return false;                                           \
+    SPSC_RING_BARRIER();                                                            \
+    *item = ring->items[tail & ((size) - 1)];                                       \
+    SPSC_RING_BARRIER();                                                            \
+    ring->tail = (uint8_t)(tail + 1);                                               \
+    return true;                                                                    \
+}                                                                                   \
+                                                                                    \
+/* index 0 is the oldest item, NULL past the newest */                              \
+static inline type *name##_peek(name##_t *ring, uint8_t index)                      \
+{                                                                                   \
+    if (index >= name##_count(ring)) return NULL;                                   \
+    SPSC_RING_BARRIER();                                                            \
+    return &ring->items[(uint8_t)(ring->tail + index) & ((size) - 1)];              \
+}                                                                                   \
+                                                                                    \
+static inline void name##_clear(name##_t *ring)                                     \
+{                                                                                   \
+    ring->tail = ring->head;                                                        \
+}
+
+#endif
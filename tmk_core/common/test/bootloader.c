@@ -0,0 +1,3 @@
+#include "bootloader.h"
+
+void bootloader_jump(void) {}
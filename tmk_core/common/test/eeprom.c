@@ -0,0 +1,89 @@
+/* EEPROM emulated in RAM for the native test platform */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "eeprom.h"
+
+#define EEPROM_SIZE 32
+
+static uint8_t buffer[EEPROM_SIZE];
+
+uint8_t eeprom_read_byte(const uint8_t *addr)
+{
+    uintptr_t offset = (uintptr_t)addr;
+    return buffer[offset];
+}
+
+void eeprom_write_byte(uint8_t *addr, uint8_t value)
+{
+    uintptr_t offset = (uintptr_t)addr;
+    buffer[offset] = value;
+}
+
+uint16_t eeprom_read_word(const uint16_t *addr)
+{
+    const uint8_t *p = (const uint8_t *)addr;
+    return eeprom_read_byte(p) | (eeprom_read_byte(p + 1) << 8);
+}
+
+uint32_t eeprom_read_dword(const uint32_t *addr)
+{
+    const uint8_t *p = (const uint8_t *)addr;
+    return eeprom_read_byte(p) | (eeprom_read_byte(p + 1) << 8)
+        | ((uint32_t)eeprom_read_byte(p + 2) << 16) | ((uint32_t)eeprom_read_byte(p + 3) << 24);
+}
+
+void eeprom_read_block(void *buf, const void *addr, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)addr;
+    uint8_t *dest = (uint8_t *)buf;
+    while (len--) {
+        *dest++ = eeprom_read_byte(p++);
+    }
+}
+
+void eeprom_write_word(uint16_t *addr, uint16_t value)
+{
+    uint8_t *p = (uint8_t *)addr;
+    eeprom_write_byte(p++, value);
+    eeprom_write_byte(p, value >> 8);
+}
+
+void eeprom_write_dword(uint32_t *addr, uint32_t value)
+{
+    uint8_t *p = (uint8_t *)addr;
+    eeprom_write_byte(p++, value);
+    eeprom_write_byte(p++, value >> 8);
+    eeprom_write_byte(p++, value >> 16);
+    eeprom_write_byte(p, value >> 24);
+}
+
+void eeprom_write_block(const void *buf, void *addr, uint32_t len)
+{
+    uint8_t *p = (uint8_t *)addr;
+    const uint8_t *src = (const uint8_t *)buf;
+    while (len--) {
+        eeprom_write_byte(p++, *src++);
+    }
+}
+
+void eeprom_update_byte(uint8_t *addr, uint8_t value)
+{
+    eeprom_write_byte(addr, value);
+}
+
+void eeprom_update_word(uint16_t *addr, uint16_t value)
+{
+    eeprom_write_word(addr, value);
+}
+
+void eeprom_update_dword(uint32_t *addr, uint32_t value)
+{
+    eeprom_write_dword(addr, value);
+}
+
+void eeprom_update_block(const void *buf, void *addr, uint32_t len)
+{
+    eeprom_write_block(buf, addr, len);
+}
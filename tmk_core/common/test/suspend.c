@@ -0,0 +1,12 @@
+#include "suspend.h"
+
+void suspend_idle(uint8_t time) {}
+
+void suspend_power_down(void) {}
+
+bool suspend_wakeup_condition(void)
+{
+    return true;
+}
+
+void suspend_wakeup_init(void) {}
@@ -0,0 +1,19 @@
+#ifndef TIMER_TEST_H
+#define TIMER_TEST_H 1
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The native test platform has no hardware timer, time only moves when the
+ * test harness tells it to. */
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
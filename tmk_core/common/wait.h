@@ -15,6 +15,9 @@ extern "C" {
 #   define wait_us(us) chThdSleepMicroseconds(us)
 #elif defined(__arm__) /* __AVR__ */
 #   include "wait_api.h"
+#else /* not AVR or ARM, e.g. the native tests */
+#   define wait_ms(ms)  ((void)(ms))
+#   define wait_us(us)  ((void)(us))
 #endif /* __AVR__ */
 
 #ifdef __cplusplus
@@ -87,6 +87,38 @@ host_driver_t chibios_driver = {
 // }
 
 
+#ifdef SCAN_THREAD
+/* Scan thread
+ * Scans the matrix once a tick, or once a frame with USB_SOF_SYNC, and wakes
+ * the main thread when keyboard_scan() queued key changes. It runs above the
+ * main thread so processing, lighting and console output cannot delay it.
+ */
+#ifndef SCAN_THREAD_PRIORITY
+#define SCAN_THREAD_PRIORITY (NORMALPRIO + 1)
+#endif
+#define SCAN_EVENT EVENT_MASK(0)
+
+static thread_t *keyboard_thread;
+static THD_WORKING_AREA(waScanThread, 256);
+static THD_FUNCTION(scanThread, arg) {
+  (void)arg;
+  chRegSetThreadName("scan");
+  while(true) {
+#ifdef USB_SOF_SYNC
+    usb_wait_sof();
+#else
+    chThdSleep(1);
+#endif
+    /* suspend_wakeup_condition() scans in the main thread meanwhile */
+    if(USB_DRIVER.state == USB_SUSPENDED) {
+      continue;
+    }
+    if(keyboard_scan()) {
+      chEvtSignal(keyboard_thread, SCAN_EVENT);
+    }
+  }
+}
+#endif
 
 /* Main thread
  */
@@ -144,6 +176,11 @@ int main(void) {
   keyboard_init();
   host_set_driver(driver);
 
+#ifdef SCAN_THREAD
+  keyboard_thread = chThdGetSelfX();
+  chThdCreateStatic(waScanThread, sizeof(waScanThread), SCAN_THREAD_PRIORITY, scanThread, NULL);
+#endif
+
 #ifdef SLEEP_LED_ENABLE
   sleep_led_init();
 #endif
@@ -181,6 +218,18 @@ int main(void) {
 #endif
     }
 
+#if defined(SCAN_THREAD)
+    /* run on new key changes, and every tick for timers and lighting */
+    chEvtWaitAnyTimeout(SCAN_EVENT, 1);
+#elif defined(USB_SOF_SYNC)
+    usb_wait_sof();
+#endif
     keyboard_task();
+#ifdef MATRIX_IDLE_SLEEP
+    /* nothing pressed or pending, let other threads run until the next tick */
+    if (keyboard_is_idle()) {
+      suspend_idle(1);
+    }
+#endif
   }
 }
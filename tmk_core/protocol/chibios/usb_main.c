@@ -23,6 +23,7 @@
 #include "host.h"
 #include "debug.h"
 #include "suspend.h"
+#include "bench.h"
 #ifdef SLEEP_LED_ENABLE
 #include "sleep_led.h"
 #include "led.h"
@@ -45,6 +46,9 @@ uint16_t keyboard_led_stats __attribute__((aligned(2))) = 0;
 volatile uint16_t keyboard_idle_count = 0;
 static virtual_timer_t keyboard_idle_timer;
 static void keyboard_idle_timer_cb(void *arg);
+#ifdef KEYBOARD_REPORT_QUEUE
+static void keyboard_report_done_i(bool reset);
+#endif /* KEYBOARD_REPORT_QUEUE */
 
 report_keyboard_t keyboard_report_sent = {{0}};
 #ifdef MOUSE_ENABLE
@@ -386,7 +390,7 @@ static const uint8_t hid_configuration_descriptor_data[] = {
   USB_DESC_ENDPOINT(KBD_ENDPOINT | 0x80,  // bEndpointAddress
                     0x03,      // bmAttributes (Interrupt)
                     KBD_EPSIZE,// wMaxPacketSize
-                    10),       // bInterval
+                    KBD_POLLING_INTERVAL), // bInterval
 
   #ifdef MOUSE_ENABLE
   /* Interface Descriptor (9 bytes) USB spec 9.6.5, page 267-269, Table 9-12 */
@@ -416,7 +420,7 @@ static const uint8_t hid_configuration_descriptor_data[] = {
   USB_DESC_ENDPOINT(MOUSE_ENDPOINT | 0x80,  // bEndpointAddress
                     0x03,      // bmAttributes (Interrupt)
                     MOUSE_EPSIZE,  // wMaxPacketSize
-                    1),        // bInterval
+                    MOUSE_POLLING_INTERVAL), // bInterval
   #endif /* MOUSE_ENABLE */
 
   #ifdef CONSOLE_ENABLE
@@ -442,7 +446,7 @@ static const uint8_t hid_configuration_descriptor_data[] = {
   USB_DESC_ENDPOINT(CONSOLE_ENDPOINT | 0x80,  // bEndpointAddress
                     0x03,      // bmAttributes (Interrupt)
                     CONSOLE_EPSIZE, // wMaxPacketSize
-                    1),        // bInterval
+                    CONSOLE_POLLING_INTERVAL), // bInterval
   #endif /* CONSOLE_ENABLE */
 
   #ifdef EXTRAKEY_ENABLE
@@ -468,7 +472,7 @@ static const uint8_t hid_configuration_descriptor_data[] = {
   USB_DESC_ENDPOINT(EXTRA_ENDPOINT | 0x80,  // bEndpointAddress
                     0x03,      // bmAttributes (Interrupt)
                     EXTRA_EPSIZE, // wMaxPacketSize
-                    10),       // bInterval
+                    EXTRA_POLLING_INTERVAL), // bInterval
   #endif /* EXTRAKEY_ENABLE */
 
   #ifdef NKRO_ENABLE
@@ -494,7 +498,7 @@ static const uint8_t hid_configuration_descriptor_data[] = {
   USB_DESC_ENDPOINT(NKRO_ENDPOINT | 0x80,  // bEndpointAddress
                     0x03,      // bmAttributes (Interrupt)
                     NKRO_EPSIZE, // wMaxPacketSize
-                    1),       // bInterval
+                    NKRO_POLLING_INTERVAL), // bInterval
   #endif /* NKRO_ENABLE */
 };
 
@@ -771,6 +775,12 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
   switch(event) {
   case USB_EVENT_RESET:
     //TODO: from ISR! print("[R]");
+#ifdef KEYBOARD_REPORT_QUEUE
+    /* a report in flight will not complete */
+    osalSysLockFromISR();
+    keyboard_report_done_i(true);
+    osalSysUnlockFromISR();
+#endif /* KEYBOARD_REPORT_QUEUE */
     return;
 
   case USB_EVENT_ADDRESS:
@@ -1054,28 +1064,125 @@ void send_remote_wakeup(USBDriver *usbp) {
  * ---------------------------------------------------------
  */
 
+#ifdef KEYBOARD_REPORT_QUEUE
+/* report host.c handed us, NULL once it has made it IN */
+static report_keyboard_t *keyboard_report_queued = NULL;
+/* false while it waits behind an idle repeat on the same endpoint */
+static bool keyboard_report_started = false;
+
+/* called with the system locked */
+static void keyboard_report_start_i(void) {
+  usbep_t ep = KBD_ENDPOINT;
+  size_t size = KBD_EPSIZE;
+#ifdef NKRO_ENABLE
+  if(keymap_config.nkro) {
+    ep = NKRO_ENDPOINT;
+    size = sizeof(report_keyboard_t);
+  }
+#endif /* NKRO_ENABLE */
+  if(usbGetTransmitStatusI(&USB_DRIVER, ep)) {
+    /* retried from the IN callback */
+    return;
+  }
+  bench_usb_transmit();
+  usbStartTransmitI(&USB_DRIVER, ep, (uint8_t *)keyboard_report_queued, size);
+  keyboard_report_sent = *keyboard_report_queued;
+  keyboard_report_started = true;
+}
+
+/* an IN transfer finished or the endpoints were reset, called locked */
+static void keyboard_report_done_i(bool reset) {
+  if(keyboard_report_queued == NULL) {
+    return;
+  }
+  if(!keyboard_report_started && !reset) {
+    keyboard_report_start_i();
+    return;
+  }
+  keyboard_report_queued = NULL;
+  keyboard_report_started = false;
+  host_keyboard_sent();
+}
+#elif defined(USB_POLLING_INTERVAL_MS)
+/* two report buffers: one in flight, the other staged behind it */
+static report_keyboard_t keyboard_report_buf[2];
+static uint8_t keyboard_report_flight = 0;
+static bool keyboard_report_staged = false;
+static usbep_t keyboard_report_staged_ep;
+static size_t keyboard_report_staged_size;
+
+/* start the staged report if its endpoint is free, called locked */
+static void keyboard_report_start_staged_i(void) {
+  if(!keyboard_report_staged || usbGetTransmitStatusI(&USB_DRIVER, keyboard_report_staged_ep)) {
+    return;
+  }
+  keyboard_report_staged = false;
+  keyboard_report_flight ^= 1;
+  bench_usb_transmit();
+  usbStartTransmitI(&USB_DRIVER, keyboard_report_staged_ep,
+                    (uint8_t *)&keyboard_report_buf[keyboard_report_flight],
+                    keyboard_report_staged_size);
+}
+#endif /* KEYBOARD_REPORT_QUEUE */
+
 /* keyboard IN callback hander (a kbd report has made it IN) */
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
-  /* STUB */
   (void)usbp;
   (void)ep;
+#ifdef KEYBOARD_REPORT_QUEUE
+  osalSysLockFromISR();
+  keyboard_report_done_i(false);
+  osalSysUnlockFromISR();
+#elif defined(USB_POLLING_INTERVAL_MS)
+  osalSysLockFromISR();
+  keyboard_report_start_staged_i();
+  osalSysUnlockFromISR();
+#endif /* KEYBOARD_REPORT_QUEUE */
 }
 
 #ifdef NKRO_ENABLE
 /* nkro IN callback hander (a nkro report has made it IN) */
 void nkro_in_cb(USBDriver *usbp, usbep_t ep) {
-  /* STUB */
   (void)usbp;
   (void)ep;
+#ifdef KEYBOARD_REPORT_QUEUE
+  osalSysLockFromISR();
+  keyboard_report_done_i(false);
+  osalSysUnlockFromISR();
+#elif defined(USB_POLLING_INTERVAL_MS)
+  osalSysLockFromISR();
+  keyboard_report_start_staged_i();
+  osalSysUnlockFromISR();
+#endif /* KEYBOARD_REPORT_QUEUE */
 }
 #endif /* NKRO_ENABLE */
 
+#ifdef USB_SOF_SYNC
+/* main thread waiting in usb_wait_sof() */
+static thread_reference_t sof_thread = NULL;
+#endif /* USB_SOF_SYNC */
+
 /* start-of-frame handler
  * TODO: i guess it would be better to re-implement using timers,
  *  so that this is not going to have to be checked every 1ms */
 void kbd_sof_cb(USBDriver *usbp) {
   (void)usbp;
+#ifdef USB_SOF_SYNC
+  osalSysLockFromISR();
+  osalThreadResumeI(&sof_thread, MSG_OK);
+  osalSysUnlockFromISR();
+#endif /* USB_SOF_SYNC */
+}
+
+#ifdef USB_SOF_SYNC
+/* block until the next start-of-frame
+ * frames stop while suspended or unplugged, so give up after two ticks */
+void usb_wait_sof(void) {
+  osalSysLock();
+  osalThreadSuspendTimeoutS(&sof_thread, MS2ST(2));
+  osalSysUnlock();
 }
+#endif /* USB_SOF_SYNC */
 
 /* Idle requests timer code
  * callback (called from ISR, unlocked state) */
@@ -1114,6 +1221,55 @@ uint8_t keyboard_leds(void) {
   return (uint8_t)(keyboard_led_stats & 0xFF);
 }
 
+#ifdef KEYBOARD_REPORT_QUEUE
+/* start sending a report IN without waiting
+ * host.c calls this with the system locked, one report at a time, and
+ * kbd_in_cb/nkro_in_cb tell it when the next one can go */
+void send_keyboard(report_keyboard_t *report) {
+  if(usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+    /* dropped, as below */
+    host_keyboard_sent();
+    return;
+  }
+  keyboard_report_queued = report;
+  keyboard_report_started = false;
+  keyboard_report_start_i();
+}
+#elif defined(USB_POLLING_INTERVAL_MS)
+/* stage a report behind the one in flight, kbd_in_cb/nkro_in_cb start it
+ * only waits when a report is staged already
+ * not callable from ISR or locked state */
+void send_keyboard(report_keyboard_t *report) {
+  usbep_t ep = KBD_ENDPOINT;
+  size_t size = KBD_EPSIZE;
+#ifdef NKRO_ENABLE
+  if(keymap_config.nkro) {
+    ep = NKRO_ENDPOINT;
+    size = sizeof(report_keyboard_t);
+  }
+#endif /* NKRO_ENABLE */
+
+  osalSysLock();
+  if(usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+    osalSysUnlock();
+    return;
+  }
+  while(keyboard_report_staged) {
+    /* the host stopped polling, replace the staged report */
+    if(osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[keyboard_report_staged_ep]->in_state->thread,
+                                 MS2ST(50)) == MSG_TIMEOUT) {
+      keyboard_report_staged = false;
+    }
+  }
+  keyboard_report_buf[keyboard_report_flight ^ 1] = *report;
+  keyboard_report_staged = true;
+  keyboard_report_staged_ep = ep;
+  keyboard_report_staged_size = size;
+  keyboard_report_start_staged_i();
+  osalSysUnlock();
+  keyboard_report_sent = *report;
+}
+#else /* KEYBOARD_REPORT_QUEUE */
 /* prepare and start sending a report IN
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
@@ -1139,6 +1295,7 @@ void send_keyboard(report_keyboard_t *report) {
        * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
       osalThreadSuspendS(&(&USB_DRIVER)->epc[NKRO_ENDPOINT]->in_state->thread);
     }
+    bench_usb_transmit();
     usbStartTransmitI(&USB_DRIVER, NKRO_ENDPOINT, (uint8_t *)report, sizeof(report_keyboard_t));
     osalSysUnlock();
   } else
@@ -1154,11 +1311,13 @@ void send_keyboard(report_keyboard_t *report) {
        * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
       osalThreadSuspendS(&(&USB_DRIVER)->epc[KBD_ENDPOINT]->in_state->thread);
     }
+    bench_usb_transmit();
     usbStartTransmitI(&USB_DRIVER, KBD_ENDPOINT, (uint8_t *)report, KBD_EPSIZE);
     osalSysUnlock();
   }
   keyboard_report_sent = *report;
 }
+#endif /* KEYBOARD_REPORT_QUEUE */
 
 /* ---------------------------------------------------------
  *                     Mouse functions
@@ -39,6 +39,46 @@ void init_usb_driver(USBDriver *usbp);
 /* Send remote wakeup packet */
 void send_remote_wakeup(USBDriver *usbp);
 
+/* Endpoint polling
+ *
+ * USB_POLLING_INTERVAL_MS sets the interval of the keyboard, NKRO, mouse and
+ * extra endpoints, 1 polls every frame at full speed. It also lets
+ * send_keyboard() stage a report behind the one in flight instead of waiting
+ * for the endpoint. Undefined, the boot keyboard and extra endpoints are
+ * polled every 10ms and the others every 1ms.
+ *
+ * Define USB_HIGH_SPEED on a high speed port, where bInterval is an exponent
+ * of 125us microframes.
+ */
+#ifdef USB_HIGH_SPEED
+#define USB_ENDPOINT_INTERVAL(ms) ((ms) >= 16 ? 8 : (ms) >= 8 ? 7 : (ms) >= 4 ? 6 : (ms) >= 2 ? 5 : 4)
+#else
+#define USB_ENDPOINT_INTERVAL(ms) (ms)
+#endif
+
+#ifdef USB_POLLING_INTERVAL_MS
+#define KBD_POLLING_INTERVAL     USB_ENDPOINT_INTERVAL(USB_POLLING_INTERVAL_MS)
+#define NKRO_POLLING_INTERVAL    USB_ENDPOINT_INTERVAL(USB_POLLING_INTERVAL_MS)
+#define MOUSE_POLLING_INTERVAL   USB_ENDPOINT_INTERVAL(USB_POLLING_INTERVAL_MS)
+#define EXTRA_POLLING_INTERVAL   USB_ENDPOINT_INTERVAL(USB_POLLING_INTERVAL_MS)
+#else
+#define KBD_POLLING_INTERVAL     USB_ENDPOINT_INTERVAL(10)
+#define NKRO_POLLING_INTERVAL    USB_ENDPOINT_INTERVAL(1)
+#define MOUSE_POLLING_INTERVAL   USB_ENDPOINT_INTERVAL(1)
+#define EXTRA_POLLING_INTERVAL   USB_ENDPOINT_INTERVAL(10)
+#endif
+#define CONSOLE_POLLING_INTERVAL USB_ENDPOINT_INTERVAL(1)
+
+#ifdef USB_SOF_SYNC
+/* Start-of-frame sync
+ *
+ * The main loop calls usb_wait_sof() before each keyboard_task(), so a scan
+ * starts with every USB frame and its report is in the endpoint a fixed time
+ * before the host polls in the next one, instead of anywhere within a frame.
+ */
+void usb_wait_sof(void);
+#endif
+
 /* ---------------
  * Keyboard header
  * ---------------
@@ -623,6 +623,45 @@ static inline uint8_t where_to_send(void) {
     ;
 }
 
+#ifdef KEYBOARD_REPORT_QUEUE
+/* report from host.c still waiting for the endpoint, see keyboard_report_flush() */
+static report_keyboard_t *keyboard_report_queued = NULL;
+
+/* Write the queued report if the endpoint has room; called from send_keyboard()
+ * and then from the main loop until it goes through, instead of waiting. */
+static void keyboard_report_flush(void)
+{
+    if (!keyboard_report_queued) return;
+
+    if (USB_DeviceState != DEVICE_STATE_Configured) {
+        /* dropped, like a timed out write */
+        keyboard_report_queued = NULL;
+        host_keyboard_sent();
+        return;
+    }
+
+    uint8_t size = KEYBOARD_EPSIZE;
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        Endpoint_SelectEndpoint(NKRO_IN_EPNUM);
+        size = NKRO_EPSIZE;
+    }
+    else
+#endif
+    {
+        Endpoint_SelectEndpoint(KEYBOARD_IN_EPNUM);
+    }
+    if (!Endpoint_IsReadWriteAllowed()) return;
+
+    Endpoint_Write_Stream_LE(keyboard_report_queued, size, NULL);
+    Endpoint_ClearIN();
+
+    keyboard_report_sent = *keyboard_report_queued;
+    keyboard_report_queued = NULL;
+    host_keyboard_sent();
+}
+#endif
+
 static void send_keyboard(report_keyboard_t *report)
 {
 #ifdef BLUETOOTH_ENABLE
@@ -642,9 +681,17 @@ static void send_keyboard(report_keyboard_t *report)
 #endif
 
     if (!(where & SendToUSB)) {
+#ifdef KEYBOARD_REPORT_QUEUE
+      host_keyboard_sent();
+#endif
       return;
     }
 
+#ifdef KEYBOARD_REPORT_QUEUE
+    (void)timeout;
+    keyboard_report_queued = report;
+    keyboard_report_flush();
+#else
     /* Select the Keyboard Report Endpoint */
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
@@ -676,6 +723,7 @@ static void send_keyboard(report_keyboard_t *report)
     Endpoint_ClearIN();
 
     keyboard_report_sent = *report;
+#endif
 }
 
 static void send_mouse(report_mouse_t *report)
@@ -1194,6 +1242,16 @@ int main(void)
         #endif
 
         keyboard_task();
+#ifdef KEYBOARD_REPORT_QUEUE
+        keyboard_report_flush();
+#endif
+
+#ifdef MATRIX_IDLE_SLEEP
+        // sleep until the next interrupt: timer tick, USB or a key press
+        if (keyboard_is_idle()) {
+            suspend_idle(0);
+        }
+#endif
 
 #ifdef MIDI_ENABLE
         midi_device_process(&midi_device);